@@ -0,0 +1,163 @@
+#include "binary_morphology.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool binary_image_reserve(BinaryImage& image, int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    int words_per_row = (width + 31) / 32;
+    size_t words = (size_t)words_per_row * height;
+    if (words > image.capacity) {
+        uint32_t* buffer = (uint32_t*)malloc(words * sizeof(uint32_t));
+        if (buffer == nullptr) {
+            return false;
+        }
+        free(image.words);
+        image.words = buffer;
+        image.capacity = words;
+    }
+    image.width = width;
+    image.height = height;
+    image.words_per_row = words_per_row;
+    return true;
+}
+
+void binary_image_release(BinaryImage& image) {
+    free(image.words);
+    image = BinaryImage();
+}
+
+// Bits válidos de la última palabra de cada fila
+static inline uint32_t last_word_mask(int width) {
+    int used = width % 32;
+    return used == 0 ? 0xffffffffu : (1u << used) - 1;
+}
+
+static inline uint32_t load_u32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Un bit por byte distinto de cero de `pixels` (4 píxeles, little-endian):
+// se marca el bit alto de cada byte y una multiplicación los junta en 4 bits
+static inline uint32_t pack_4(uint32_t pixels) {
+    uint32_t high = (((pixels & 0x7f7f7f7fu) + 0x7f7f7f7fu) | pixels) & 0x80808080u;
+    return ((high >> 7) * 0x01020408u) >> 24;
+}
+
+void binary_pack(const uint8_t* src, size_t src_stride, BinaryImage& image) {
+    for (int y = 0; y < image.height; y++) {
+        const uint8_t* row = src + y * src_stride;
+        uint32_t* words = image.words + (size_t)y * image.words_per_row;
+        memset(words, 0, image.words_per_row * sizeof(uint32_t));
+        int x = 0;
+        for (; x + 4 <= image.width; x += 4) {
+            words[x / 32] |= pack_4(load_u32(row + x)) << (x % 32);
+        }
+        for (; x < image.width; x++) {
+            words[x / 32] |= (uint32_t)(row[x] != 0) << (x % 32);
+        }
+    }
+}
+
+// 4 bits a 4 bytes de 0 o 255
+static const uint32_t kUnpackNibble[16] = {
+    0x00000000u, 0x000000ffu, 0x0000ff00u, 0x0000ffffu, 0x00ff0000u, 0x00ff00ffu, 0x00ffff00u, 0x00ffffffu,
+    0xff000000u, 0xff0000ffu, 0xff00ff00u, 0xff00ffffu, 0xffff0000u, 0xffff00ffu, 0xffffff00u, 0xffffffffu,
+};
+
+void binary_unpack(const BinaryImage& image, uint8_t* dst, size_t dst_stride) {
+    for (int y = 0; y < image.height; y++) {
+        uint8_t* row = dst + y * dst_stride;
+        const uint32_t* words = image.words + (size_t)y * image.words_per_row;
+        int x = 0;
+        for (; x + 4 <= image.width; x += 4) {
+            uint32_t pixels = kUnpackNibble[(words[x / 32] >> (x % 32)) & 0xf];
+            memcpy(row + x, &pixels, sizeof(pixels));
+        }
+        for (; x < image.width; x++) {
+            row[x] = (words[x / 32] >> (x % 32)) & 1 ? 255 : 0;
+        }
+    }
+}
+
+// Pasada horizontal en el lugar: cada bit se combina con su vecino de la
+// izquierda y, si `with_right`, con el de la derecha. Fuera de la imagen el
+// vecino vale `outside` (0 para dilatar, 1 para erosionar, así no cuenta).
+static void horizontal_pass(BinaryImage& image, bool dilate, bool with_right) {
+    const uint32_t outside = dilate ? 0u : 0xffffffffu;
+    const uint32_t mask = last_word_mask(image.width);
+    const int last = image.words_per_row - 1;
+    for (int y = 0; y < image.height; y++) {
+        uint32_t* words = image.words + (size_t)y * image.words_per_row;
+        uint32_t previous = outside;
+        for (int i = 0; i <= last; i++) {
+            uint32_t word = words[i];
+            // Los bits de relleno de la última palabra valen lo mismo que afuera
+            uint32_t next = i < last ? words[i + 1] : outside;
+            if (i == last && !dilate) {
+                word |= ~mask;
+            }
+            uint32_t left = (word << 1) | (previous >> 31);
+            uint32_t result = dilate ? word | left : word & left;
+            if (with_right) {
+                uint32_t right = (word >> 1) | (next << 31);
+                result = dilate ? result | right : result & right;
+            }
+            previous = word;
+            words[i] = i == last ? result & mask : result;
+        }
+    }
+}
+
+// Pasada vertical en el lugar con la fila de arriba y la de abajo, columna de
+// palabras por columna de palabras
+static void vertical_pass(BinaryImage& image, bool dilate) {
+    const int stride = image.words_per_row;
+    for (int i = 0; i < stride; i++) {
+        uint32_t* column = image.words + i;
+        uint32_t above = 0;
+        uint32_t current = column[0];
+        for (int y = 0; y < image.height; y++) {
+            bool has_below = y + 1 < image.height;
+            uint32_t below = has_below ? column[(size_t)(y + 1) * stride] : 0;
+            uint32_t result;
+            if (dilate) {
+                result = above | current | below;
+            } else {
+                result = current;
+                if (y > 0) {
+                    result &= above;
+                }
+                if (has_below) {
+                    result &= below;
+                }
+            }
+            column[(size_t)y * stride] = result;
+            above = current;
+            current = below;
+        }
+    }
+}
+
+void binary_dilate_3x3(BinaryImage& image) {
+    horizontal_pass(image, true, true);
+    vertical_pass(image, true);
+}
+
+void binary_dilate_3x2(BinaryImage& image) {
+    horizontal_pass(image, true, false);
+    vertical_pass(image, true);
+}
+
+void binary_erode_3x2(BinaryImage& image) {
+    horizontal_pass(image, false, false);
+    vertical_pass(image, false);
+}
+
+void binary_close_3x2(BinaryImage& image) {
+    binary_dilate_3x2(image);
+    binary_erode_3x2(image);
+}
@@ -0,0 +1,251 @@
+#include "canny.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Valores del mapa mientras se calcula, escritos en el propio `dst`
+#define MAP_WEAK 0   // máximo local entre los dos umbrales: borde si se conecta a uno fuerte
+#define MAP_NONE 1
+#define MAP_EDGE 2
+
+// tan(22.5°) en Q15, como en OpenCV
+#define CANNY_SHIFT 15
+#define TG22 13573
+
+// La pila de la histéresis guarda (y << 16) | x. Después de la supresión de no
+// máximos los bordes tienen un píxel de ancho, así que un octavo de la imagen
+// alcanza de sobra; si aun así se llena, el resto se propaga con barridos. La
+// prueba de host la achica a una fila para cubrir ese camino.
+#ifndef CANNY_STACK_FRACTION
+#define CANNY_STACK_FRACTION 8
+#endif
+
+struct CannyWorkspace {
+    int width;
+    int height;
+    // Tres filas (anterior, actual, siguiente) de dx, dy y magnitud, con una
+    // columna de ceros a cada lado en la magnitud
+    int16_t* dx[3];
+    int16_t* dy[3];
+    int16_t* mag[3];
+    int16_t* zero_mag;
+    // Sumas verticales del Sobel de una fila
+    int16_t* column_sum;
+    int16_t* column_diff;
+    uint32_t* stack;
+    size_t stack_capacity;
+    void* block;
+};
+
+static CannyWorkspace workspace;
+
+bool canny_reserve(int width, int height) {
+    if (width <= 0 || height <= 0 || width > 0xffff || height > 0xffff) {
+        return false;
+    }
+    if (workspace.block != nullptr && width <= workspace.width && height <= workspace.height) {
+        return true;
+    }
+    // Se conserva el máximo de cada dimensión: una imagen más ancha pero más
+    // baja que la anterior no debe achicar el alto reservado
+    if (workspace.block != nullptr) {
+        width = width > workspace.width ? width : workspace.width;
+        height = height > workspace.height ? height : workspace.height;
+    }
+
+    size_t row = (size_t)width + 2;
+    size_t rows_bytes = (3 * 3 + 1 + 2) * row * sizeof(int16_t);
+    rows_bytes = (rows_bytes + sizeof(uint32_t) - 1) / sizeof(uint32_t) * sizeof(uint32_t);
+    size_t stack_capacity = (size_t)width * height / CANNY_STACK_FRACTION + (size_t)width;
+    uint8_t* block = (uint8_t*)malloc(rows_bytes + stack_capacity * sizeof(uint32_t));
+    if (block == nullptr) {
+        return false;
+    }
+    free(workspace.block);
+
+    memset(block, 0, rows_bytes);
+    int16_t* rows = (int16_t*)block;
+    for (int i = 0; i < 3; i++) {
+        workspace.dx[i] = rows + (0 + i) * row;
+        workspace.dy[i] = rows + (3 + i) * row;
+        workspace.mag[i] = rows + (6 + i) * row + 1;
+    }
+    workspace.zero_mag = rows + 9 * row + 1;
+    workspace.column_sum = rows + 10 * row;
+    workspace.column_diff = rows + 11 * row;
+    workspace.stack = (uint32_t*)(block + rows_bytes);
+    workspace.stack_capacity = stack_capacity;
+    workspace.block = block;
+    workspace.width = width;
+    workspace.height = height;
+    return true;
+}
+
+static inline int16_t abs16(int16_t value) {
+    return value < 0 ? (int16_t)-value : value;
+}
+
+// Sobel 3x3 de la fila y con borde replicado, y su magnitud L1
+static void sobel_row(const uint8_t* src, size_t src_stride, int width, int height, int y, int16_t* dx, int16_t* dy,
+                      int16_t* mag) {
+    const uint8_t* above = src + (y > 0 ? y - 1 : 0) * src_stride;
+    const uint8_t* center = src + y * src_stride;
+    const uint8_t* below = src + (y < height - 1 ? y + 1 : y) * src_stride;
+    int16_t* column_sum = workspace.column_sum;
+    int16_t* column_diff = workspace.column_diff;
+
+    for (int x = 0; x < width; x++) {
+        column_sum[x] = (int16_t)(above[x] + 2 * center[x] + below[x]);
+        column_diff[x] = (int16_t)(below[x] - above[x]);
+    }
+    for (int x = 0; x < width; x++) {
+        int left = x > 0 ? x - 1 : 0;
+        int right = x < width - 1 ? x + 1 : x;
+        dx[x] = (int16_t)(column_sum[right] - column_sum[left]);
+        dy[x] = (int16_t)(column_diff[left] + 2 * column_diff[x] + column_diff[right]);
+        mag[x] = (int16_t)(abs16(dx[x]) + abs16(dy[x]));
+    }
+}
+
+// Marca como borde y apila; si la pila está llena devuelve false y el píxel
+// queda marcado sin apilar
+static inline bool push_edge(uint8_t* pixel, uint32_t position, size_t& top) {
+    *pixel = MAP_EDGE;
+    if (top == workspace.stack_capacity) {
+        return false;
+    }
+    workspace.stack[top++] = position;
+    return true;
+}
+
+// Alternativa sin pila: barridos de la imagen hasta que ningún borde débil
+// tenga un vecino marcado
+static void hysteresis_sweeps(uint8_t* dst, size_t dst_stride, int width, int height) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int y = 0; y < height; y++) {
+            uint8_t* row = dst + y * dst_stride;
+            for (int x = 0; x < width; x++) {
+                if (row[x] != MAP_WEAK) {
+                    continue;
+                }
+                for (int ny = (y > 0 ? y - 1 : 0); ny <= (y < height - 1 ? y + 1 : y) && row[x] == MAP_WEAK; ny++) {
+                    const uint8_t* neighbours = dst + ny * dst_stride;
+                    for (int nx = (x > 0 ? x - 1 : 0); nx <= (x < width - 1 ? x + 1 : x); nx++) {
+                        if (neighbours[nx] == MAP_EDGE) {
+                            row[x] = MAP_EDGE;
+                            changed = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool canny_edges(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride, int width, int height,
+                 int low_threshold, int high_threshold) {
+    if (width <= 0 || height <= 0) {
+        return true;
+    }
+    if (workspace.block == nullptr || width > workspace.width || height > workspace.height) {
+        return false;
+    }
+    if (low_threshold > high_threshold) {
+        int swap = low_threshold;
+        low_threshold = high_threshold;
+        high_threshold = swap;
+    }
+
+    // Columnas de borde de la magnitud en cero (la reserva pudo ser más ancha)
+    for (int i = 0; i < 3; i++) {
+        workspace.mag[i][-1] = 0;
+        workspace.mag[i][width] = 0;
+    }
+    workspace.zero_mag[width] = 0;
+
+    size_t top = 0;
+    bool overflow = false;
+    int current = 0;
+    sobel_row(src, src_stride, width, height, 0, workspace.dx[0], workspace.dy[0], workspace.mag[0]);
+
+    for (int y = 0; y < height; y++) {
+        int next = (current + 1) % 3;
+        int previous = (current + 2) % 3;
+        // La fila siguiente se calcula antes de escribir la fila y de `dst`, así
+        // que con `dst` == `src` todavía se leen los píxeles originales
+        if (y + 1 < height) {
+            sobel_row(src, src_stride, width, height, y + 1, workspace.dx[next], workspace.dy[next],
+                      workspace.mag[next]);
+        }
+        const int16_t* mag_above = y > 0 ? workspace.mag[previous] : workspace.zero_mag;
+        const int16_t* mag = workspace.mag[current];
+        const int16_t* mag_below = y + 1 < height ? workspace.mag[next] : workspace.zero_mag;
+        const int16_t* dx = workspace.dx[current];
+        const int16_t* dy = workspace.dy[current];
+        uint8_t* out = dst + y * dst_stride;
+
+        for (int x = 0; x < width; x++) {
+            int m = mag[x];
+            out[x] = MAP_NONE;
+            if (m <= low_threshold) {
+                continue;
+            }
+
+            // Supresión de no máximos en la dirección del gradiente, en 4 sectores
+            int xs = dx[x];
+            int ys = dy[x];
+            int ax = xs < 0 ? -xs : xs;
+            int ay = (ys < 0 ? -ys : ys) << CANNY_SHIFT;
+            int tg22x = ax * TG22;
+            bool maximum;
+            if (ay < tg22x) {
+                maximum = m > mag[x - 1] && m >= mag[x + 1];
+            } else {
+                int tg67x = tg22x + (ax << (CANNY_SHIFT + 1));
+                if (ay > tg67x) {
+                    maximum = m > mag_above[x] && m >= mag_below[x];
+                } else {
+                    int s = (xs ^ ys) < 0 ? -1 : 1;
+                    maximum = m > mag_above[x - s] && m > mag_below[x + s];
+                }
+            }
+            if (!maximum) {
+                continue;
+            }
+            if (m > high_threshold) {
+                overflow |= !push_edge(&out[x], ((uint32_t)y << 16) | (uint32_t)x, top);
+            } else {
+                out[x] = MAP_WEAK;
+            }
+        }
+        current = next;
+    }
+
+    // Histéresis: los débiles conectados (8 vecinos) a un borde pasan a borde
+    while (top > 0) {
+        uint32_t position = workspace.stack[--top];
+        int y = (int)(position >> 16);
+        int x = (int)(position & 0xffff);
+        for (int ny = (y > 0 ? y - 1 : 0); ny <= (y < height - 1 ? y + 1 : y); ny++) {
+            uint8_t* row = dst + ny * dst_stride;
+            for (int nx = (x > 0 ? x - 1 : 0); nx <= (x < width - 1 ? x + 1 : x); nx++) {
+                if (row[nx] == MAP_WEAK) {
+                    overflow |= !push_edge(&row[nx], ((uint32_t)ny << 16) | (uint32_t)nx, top);
+                }
+            }
+        }
+    }
+    if (overflow) {
+        hysteresis_sweeps(dst, dst_stride, width, height);
+    }
+
+    for (int y = 0; y < height; y++) {
+        uint8_t* out = dst + y * dst_stride;
+        for (int x = 0; x < width; x++) {
+            out[x] = out[x] == MAP_EDGE ? 255 : 0;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,131 @@
+#include "char_preprocess.h"
+#include <math.h>
+#include <string.h>
+
+// Mismos bits de precisión que usa OpenCV para INTER_LINEAR en 8 bits (el
+// resultado no es idéntico: ver crop_resize_quantize)
+#define RESIZE_COEF_BITS 11
+#define RESIZE_COEF_SCALE (1 << RESIZE_COEF_BITS)
+
+// Índice de origen y peso del píxel izquierdo/superior para una coordenada destino
+static inline void linear_coef(int dst_index, float scale, int src_size, int* src_index, int* weight) {
+    float f = (dst_index + 0.5f) * scale - 0.5f;
+    int s = (int)floorf(f);
+    f -= s;
+
+    if (s < 0) {
+        s = 0;
+        f = 0;
+    }
+    if (s >= src_size - 1) {
+        s = src_size - 1;
+        f = 0;
+    }
+
+    *src_index = s;
+    *weight = (int)lrintf((1.0f - f) * RESIZE_COEF_SCALE);
+}
+
+bool crop_resize_quantize(const CharCrop& crop, int8_t* dst, int dst_width, int dst_height, int zero_shift) {
+    if (dst_width > kCropMaxDstWidth) {
+        return false;
+    }
+
+    const uint8_t* origin = crop.base + crop.y * crop.stride + crop.x;
+
+    // Recorte ya del tamaño de la entrada: la interpolación a escala 1 devuelve
+    // el mismo píxel, así que se copia directo (sin desplazar si el modelo
+    // recibe uint8 o trae el punto cero plegado en la primera convolución)
+    if (crop.width == dst_width && crop.height == dst_height) {
+        for (int dy = 0; dy < dst_height; dy++) {
+            const uint8_t* row = origin + dy * crop.stride;
+            int8_t* out = dst + dy * dst_width;
+            if (zero_shift == 0) {
+                memcpy(out, row, dst_width);
+                continue;
+            }
+            for (int dx = 0; dx < dst_width; dx++) {
+                out[dx] = (int8_t)(row[dx] + zero_shift);
+            }
+        }
+        return true;
+    }
+
+    const float scale_x = (float)crop.width / dst_width;
+    const float scale_y = (float)crop.height / dst_height;
+
+    // Coeficientes horizontales: se calculan una vez por recorte
+    int x0[kCropMaxDstWidth];
+    int x1[kCropMaxDstWidth];
+    int ax[kCropMaxDstWidth];
+    for (int dx = 0; dx < dst_width; dx++) {
+        linear_coef(dx, scale_x, crop.width, &x0[dx], &ax[dx]);
+        x1[dx] = (x0[dx] + 1 < crop.width) ? x0[dx] + 1 : x0[dx];
+    }
+
+    for (int dy = 0; dy < dst_height; dy++) {
+        int y0, by;
+        linear_coef(dy, scale_y, crop.height, &y0, &by);
+        int y1 = (y0 + 1 < crop.height) ? y0 + 1 : y0;
+
+        const uint8_t* row0 = origin + y0 * crop.stride;
+        const uint8_t* row1 = origin + y1 * crop.stride;
+        int8_t* out = dst + dy * dst_width;
+
+        for (int dx = 0; dx < dst_width; dx++) {
+            int a0 = ax[dx];
+            int a1 = RESIZE_COEF_SCALE - a0;
+            int top = row0[x0[dx]] * a0 + row0[x1[dx]] * a1;
+            int bottom = row1[x0[dx]] * a0 + row1[x1[dx]] * a1;
+            int value = (top * by + bottom * (RESIZE_COEF_SCALE - by) + (1 << (2 * RESIZE_COEF_BITS - 1)))
+                        >> (2 * RESIZE_COEF_BITS);
+            out[dx] = (int8_t)(value + zero_shift);
+        }
+    }
+    return true;
+}
+
+CropHash crop_hash(const CharCrop& crop) {
+    uint32_t means[kCropHashRows * kCropHashCols];
+    uint32_t total = 0;
+
+    for (int cy = 0; cy < kCropHashRows; cy++) {
+        // Cada celda tiene al menos una fila y una columna aunque el recorte sea chico
+        int y0 = cy * crop.height / kCropHashRows;
+        int y1 = (cy + 1) * crop.height / kCropHashRows;
+        y1 = y1 > y0 ? y1 : y0 + 1;
+        for (int cx = 0; cx < kCropHashCols; cx++) {
+            int x0 = cx * crop.width / kCropHashCols;
+            int x1 = (cx + 1) * crop.width / kCropHashCols;
+            x1 = x1 > x0 ? x1 : x0 + 1;
+
+            uint32_t sum = 0;
+            for (int y = y0; y < y1; y++) {
+                const uint8_t* row = crop.base + (crop.y + y) * crop.stride + crop.x;
+                for (int x = x0; x < x1; x++) {
+                    sum += row[x];
+                }
+            }
+            uint32_t mean = sum / ((y1 - y0) * (x1 - x0));
+            means[cy * kCropHashCols + cx] = mean;
+            total += mean;
+        }
+    }
+
+    uint32_t average = total / (kCropHashRows * kCropHashCols);
+    CropHash hash = {};
+    for (int i = 0; i < kCropHashRows * kCropHashCols; i++) {
+        if (means[i] > average) {
+            hash.bits[i / 64] |= 1ull << (i % 64);
+        }
+    }
+    return hash;
+}
+
+int crop_hash_distance(const CropHash& a, const CropHash& b) {
+    int distance = 0;
+    for (size_t i = 0; i < sizeof(a.bits) / sizeof(a.bits[0]); i++) {
+        distance += __builtin_popcountll(a.bits[i] ^ b.bits[i]);
+    }
+    return distance;
+}
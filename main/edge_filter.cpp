@@ -0,0 +1,89 @@
+#include "edge_filter.h"
+#include <math.h>
+#include <string.h>
+
+#define WEIGHT_BITS 16
+#define WEIGHT_ROUND (1 << (WEIGHT_BITS - 1))
+
+// Pesos de una iteración en Q16: a^(1 + sigma_space / sigma_color * |diferencia|)
+static void build_weights(uint16_t* weights, int sigma_space, int sigma_color, int iteration, int iterations) {
+    // La desviación de cada iteración se reduce a la mitad para que la suma de
+    // las pasadas tenga la varianza de sigma_space
+    float sigma_h = sigma_space * sqrtf(3.0f) * (float)(1 << (iterations - iteration - 1)) /
+                    sqrtf((float)((1 << (2 * iterations)) - 1));
+    float a = expf(-sqrtf(2.0f) / sigma_h);
+    float ratio = (float)sigma_space / sigma_color;
+    for (int diff = 0; diff < 256; diff++) {
+        float w = powf(a, 1.0f + ratio * diff);
+        int value = (int)lrintf(w * (1 << WEIGHT_BITS));
+        weights[diff] = (uint16_t)(value > 0xffff ? 0xffff : value);
+    }
+}
+
+// Acerca `value` a `toward` en la fracción `weight` (Q16). El resultado queda
+// entre ambos, así que nunca sale de 0..255.
+static inline uint8_t blend(uint8_t value, uint8_t toward, uint16_t weight) {
+    return (uint8_t)(value + ((weight * (toward - value) + WEIGHT_ROUND) >> WEIGHT_BITS));
+}
+
+static inline int abs_diff(uint8_t a, uint8_t b) {
+    return a > b ? a - b : b - a;
+}
+
+static void filter_rows(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride, int width,
+                        int height, const uint16_t* weights) {
+    for (int y = 0; y < height; y++) {
+        const uint8_t* guide = src + y * src_stride;
+        uint8_t* out = dst + y * dst_stride;
+        for (int x = 1; x < width; x++) {
+            out[x] = blend(out[x], out[x - 1], weights[abs_diff(guide[x], guide[x - 1])]);
+        }
+        for (int x = width - 2; x >= 0; x--) {
+            out[x] = blend(out[x], out[x + 1], weights[abs_diff(guide[x], guide[x + 1])]);
+        }
+    }
+}
+
+// Por columnas se recorre fila a fila (todas las columnas a la vez) para leer
+// la memoria en orden
+static void filter_columns(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride, int width,
+                           int height, const uint16_t* weights) {
+    for (int y = 1; y < height; y++) {
+        const uint8_t* guide = src + y * src_stride;
+        const uint8_t* guide_prev = guide - src_stride;
+        uint8_t* out = dst + y * dst_stride;
+        const uint8_t* out_prev = out - dst_stride;
+        for (int x = 0; x < width; x++) {
+            out[x] = blend(out[x], out_prev[x], weights[abs_diff(guide[x], guide_prev[x])]);
+        }
+    }
+    for (int y = height - 2; y >= 0; y--) {
+        const uint8_t* guide = src + y * src_stride;
+        const uint8_t* guide_next = guide + src_stride;
+        uint8_t* out = dst + y * dst_stride;
+        const uint8_t* out_next = out + dst_stride;
+        for (int x = 0; x < width; x++) {
+            out[x] = blend(out[x], out_next[x], weights[abs_diff(guide[x], guide_next[x])]);
+        }
+    }
+}
+
+void domain_transform_filter(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                             int width, int height, int sigma_space, int sigma_color, int iterations) {
+    if (width <= 0 || height <= 0 || src == dst) {
+        return;
+    }
+    for (int y = 0; y < height; y++) {
+        memcpy(dst + y * dst_stride, src + y * src_stride, width);
+    }
+    if (sigma_space <= 0 || sigma_color <= 0) {
+        return;
+    }
+
+    uint16_t weights[256];
+    for (int i = 0; i < iterations; i++) {
+        build_weights(weights, sigma_space, sigma_color, i, iterations);
+        filter_rows(src, src_stride, dst, dst_stride, width, height, weights);
+        filter_columns(src, src_stride, dst, dst_stride, width, height, weights);
+    }
+}
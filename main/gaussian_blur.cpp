@@ -0,0 +1,143 @@
+#include "gaussian_blur.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Con el kernel [1 4 6 4 1] una pasada suma hasta 16 * 255 = 4080 y las dos
+// juntas hasta 256 * 255 = 65280: cada suma entra en un carril de 16 bits, así
+// que se calculan dos columnas por palabra de 32 bits sin acarreo entre ellas.
+// Los carriles siguen el orden de memoria de un procesador little-endian (el
+// ESP32 y el host): el carril bajo es la columna de la izquierda.
+constexpr int kRadius = 2;
+constexpr uint32_t kByteLanes = 0x00ff00ffu;
+// +128 en cada carril antes de dividir por 256: mismo redondeo que el punto
+// fijo de OpenCV
+constexpr uint32_t kRoundLanes = 0x00800080u;
+
+// Fila de sumas con su borde, reservada la primera vez y reutilizada en cada
+// llamada (y en cada franja); solo se vuelve a reservar si la imagen es más
+// ancha. Es chica (~1 KB a 450 px): malloc la deja en RAM interna.
+static uint16_t* row_buffer = nullptr;
+static size_t row_capacity = 0;
+
+static uint16_t* reserve_row(int width) {
+    size_t needed = (size_t)width + 2 * kRadius;
+    if (needed > row_capacity) {
+        uint16_t* buffer = (uint16_t*)malloc(needed * sizeof(uint16_t));
+        if (buffer == nullptr) {
+            return nullptr;
+        }
+        free(row_buffer);
+        row_buffer = buffer;
+        row_capacity = needed;
+    }
+    return row_buffer;
+}
+
+static inline int reflect_101(int i, int n) {
+    if (n == 1) {
+        return 0;
+    }
+    while (i < 0 || i >= n) {
+        i = i < 0 ? -i : 2 * n - 2 - i;
+    }
+    return i;
+}
+
+static inline uint32_t load_u32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Dos sumas consecutivas como una palabra de dos carriles
+static inline uint32_t load_lanes(const uint16_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// a + 4b + 6c + 4d + e, carril por carril
+static inline uint32_t binomial_lanes(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e) {
+    return a + e + ((b + d) << 2) + (c << 2) + (c << 1);
+}
+
+// Pasada vertical: sums[x] = suma ponderada de la columna x en las cinco filas
+static void vertical_pass(const uint8_t* const rows[5], uint16_t* sums, int width) {
+    int x = 0;
+    // Cuatro píxeles por iteración: las columnas pares y las impares de una
+    // palabra de 4 bytes quedan en dos palabras de dos carriles
+    for (; x + 4 <= width; x += 4) {
+        uint32_t w0 = load_u32(rows[0] + x);
+        uint32_t w1 = load_u32(rows[1] + x);
+        uint32_t w2 = load_u32(rows[2] + x);
+        uint32_t w3 = load_u32(rows[3] + x);
+        uint32_t w4 = load_u32(rows[4] + x);
+        uint32_t even = binomial_lanes(w0 & kByteLanes, w1 & kByteLanes, w2 & kByteLanes, w3 & kByteLanes,
+                                       w4 & kByteLanes);
+        uint32_t odd = binomial_lanes((w0 >> 8) & kByteLanes, (w1 >> 8) & kByteLanes, (w2 >> 8) & kByteLanes,
+                                      (w3 >> 8) & kByteLanes, (w4 >> 8) & kByteLanes);
+        sums[x] = (uint16_t)even;
+        sums[x + 1] = (uint16_t)odd;
+        sums[x + 2] = (uint16_t)(even >> 16);
+        sums[x + 3] = (uint16_t)(odd >> 16);
+    }
+    for (; x < width; x++) {
+        sums[x] = (uint16_t)(rows[0][x] + rows[4][x] + 4 * (rows[1][x] + rows[3][x]) + 6 * rows[2][x]);
+    }
+}
+
+// Pasada horizontal sobre las sumas con kRadius columnas de borde a cada lado
+// (`padded` empieza en la columna -kRadius)
+static void horizontal_pass(const uint16_t* padded, uint8_t* out, int width) {
+    int x = 0;
+    // Dos píxeles por palabra: los vecinos impares salen de juntar dos palabras
+    // consecutivas
+    for (; x + 2 <= width; x += 2) {
+        uint32_t w0 = load_lanes(padded + x);
+        uint32_t w1 = load_lanes(padded + x + 2);
+        uint32_t w2 = load_lanes(padded + x + 4);
+        uint32_t shifted_01 = (w0 >> 16) | (w1 << 16);
+        uint32_t shifted_12 = (w1 >> 16) | (w2 << 16);
+        uint32_t total = binomial_lanes(w0, shifted_01, w1, shifted_12, w2) + kRoundLanes;
+        out[x] = (uint8_t)(total >> 8);
+        out[x + 1] = (uint8_t)(total >> 24);
+    }
+    for (; x < width; x++) {
+        const uint16_t* s = padded + x;
+        uint32_t total = s[0] + s[4] + 4 * (s[1] + s[3]) + 6 * s[2] + 128;
+        out[x] = (uint8_t)(total >> 8);
+    }
+}
+
+bool gaussian_blur_5x5_rows(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride, int width,
+                            int height, int first_row, int row_count) {
+    if (width <= 0 || height <= 0 || row_count <= 0) {
+        return true;
+    }
+
+    uint16_t* padded = reserve_row(width);
+    if (padded == nullptr) {
+        return false;
+    }
+    uint16_t* sums = padded + kRadius;
+
+    for (int i = 0; i < row_count; i++) {
+        int y = first_row + i;
+        const uint8_t* rows[5];
+        for (int k = 0; k < 5; k++) {
+            rows[k] = src + reflect_101(y + k - kRadius, height) * src_stride;
+        }
+        vertical_pass(rows, sums, width);
+        for (int k = 1; k <= kRadius; k++) {
+            sums[-k] = sums[reflect_101(-k, width)];
+            sums[width - 1 + k] = sums[reflect_101(width - 1 + k, width)];
+        }
+        horizontal_pass(padded, dst + i * dst_stride, width);
+    }
+    return true;
+}
+
+bool gaussian_blur_5x5(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride, int width,
+                       int height) {
+    return gaussian_blur_5x5_rows(src, src_stride, dst, dst_stride, width, height, 0, height);
+}
@@ -0,0 +1,333 @@
+// Generado por tools/tflite_to_cc.py. No editar a mano.
+#include "sdkconfig.h"
+#if CONFIG_PLATE_BACKEND_CODEGEN
+#include "char_models_gen.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include "esp_nn.h"
+#include "tf_model_data.h"
+
+static inline void apply_lut(const int8_t *lut, const int8_t *src, int8_t *dst, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        dst[i] = lut[src[i] + 128];
+    }
+}
+
+// Softmax en float sobre los logits decuantizados, requantizado al formato de salida
+static void softmax_s8(const int8_t *src, int8_t *dst, int size, float in_scale, float beta, float out_scale,
+                       int out_zero_point)
+{
+    int max_value = -128;
+    for (int i = 0; i < size; i++)
+    {
+        max_value = src[i] > max_value ? src[i] : max_value;
+    }
+
+    float exps[64];
+    float sum = 0.0f;
+    for (int i = 0; i < size && i < 64; i++)
+    {
+        exps[i] = expf(beta * in_scale * (src[i] - max_value));
+        sum += exps[i];
+    }
+    for (int i = 0; i < size && i < 64; i++)
+    {
+        int q = (int)lrintf(exps[i] / sum / out_scale) + out_zero_point;
+        dst[i] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+    }
+}
+
+// ---- Modelo "letter" ----
+
+static const int8_t letter_lut0[256] = {
+    -128, -127, -127, -125, -124, -124, -122, -121, -121, -120, -118, -118,
+    -117, -115, -115, -114, -112, -112, -111, -109, -108, -108, -106, -105,
+    -105, -103, -102, -102, -100, -99, -99, -97, -96, -96, -94, -93,
+    -93, -91, -90, -90, -88, -87, -87, -85, -84, -84, -83, -81,
+    -81, -80, -78, -78, -77, -75, -75, -74, -72, -71, -71, -69,
+    -68, -68, -66, -65, -65, -63, -62, -62, -60, -59, -59, -57,
+    -56, -56, -54, -53, -53, -51, -50, -50, -48, -47, -47, -46,
+    -44, -44, -43, -41, -41, -40, -38, -38, -37, -35, -34, -34,
+    -32, -31, -31, -29, -28, -28, -26, -25, -25, -23, -22, -22,
+    -20, -19, -19, -17, -16, -16, -14, -13, -13, -11, -10, -10,
+    -9, -7, -7, -6, -4, -4, -3, -1, -1, 0, 2, 3,
+    3, 5, 6, 6, 8, 9, 9, 11, 12, 12, 14, 15,
+    15, 17, 18, 18, 20, 21, 21, 23, 24, 24, 26, 27,
+    27, 28, 30, 30, 31, 33, 33, 34, 36, 36, 37, 39,
+    40, 40, 42, 43, 43, 45, 46, 46, 48, 49, 49, 51,
+    52, 52, 54, 55, 55, 57, 58, 58, 60, 61, 61, 63,
+    64, 64, 65, 67, 67, 68, 70, 70, 71, 73, 73, 74,
+    76, 77, 77, 79, 80, 80, 82, 83, 83, 85, 86, 86,
+    88, 89, 89, 91, 92, 92, 94, 95, 95, 97, 98, 98,
+    100, 101, 101, 102, 104, 104, 105, 107, 107, 108, 110, 110,
+    111, 113, 114, 114, 116, 117, 117, 119, 120, 120, 122, 123,
+    123, 125, 126, 126,
+};
+static int32_t letter_conv0_mult[32] = {
+    1286724445, 1781699236, 1982766851, 1105411766, 1259937893, 1338860299, 1461116474, 1902558187, 1413179981, 1818595216, 1740113029, 1961430884,
+    2033021271, 2017097606, 1119885497, 2071406418, 1718425299, 1096637105, 1769802539, 1730958626, 2103074299, 1497170060, 1649268244, 1643332657,
+    1452206989, 1127860883, 1339980425, 1619236165, 1838589917, 2046185204, 1614844277, 1267219660,
+};
+static int32_t letter_conv0_shift[32] = {
+    -11, -9, -9, -8, -9, -11, -10, -10, -9, -9, -9, -12,
+    -12, -9, -10, -9, -9, -9, -12, -9, -10, -10, -9, -9,
+    -10, -8, -9, -11, -11, -9, -10, -9,
+};
+static const data_dims_t letter_conv0_input_dims = {20, 32, 1, 1};
+static const data_dims_t letter_conv0_filter_dims = {3, 3, 0, 0};
+static const data_dims_t letter_conv0_output_dims = {20, 32, 32, 1};
+static const conv_params_t letter_conv0_params = {6, -6, {1, 1}, {1, 1}, {0, 0}, {-128, 127}};
+static const quant_data_t letter_conv0_quant = {letter_conv0_shift, letter_conv0_mult};
+static const int8_t letter_lut1[256] = {
+    -128, -128, -127, -127, -127, -126, -126, -125, -125, -124, -124, -123,
+    -123, -122, -122, -122, -121, -121, -120, -120, -119, -119, -118, -118,
+    -118, -117, -117, -116, -116, -115, -115, -114, -114, -113, -113, -113,
+    -112, -112, -111, -111, -110, -110, -109, -109, -108, -108, -108, -107,
+    -107, -106, -106, -105, -105, -104, -104, -104, -103, -103, -102, -102,
+    -101, -101, -100, -100, -99, -99, -99, -98, -98, -97, -97, -96,
+    -96, -95, -95, -94, -94, -94, -93, -93, -92, -92, -91, -91,
+    -90, -90, -90, -89, -89, -88, -88, -87, -87, -86, -86, -85,
+    -85, -85, -84, -84, -83, -83, -82, -82, -81, -81, -80, -80,
+    -80, -79, -79, -78, -78, -77, -77, -76, -76, -76, -75, -75,
+    -74, -74, -73, -71, -70, -68, -67, -65, -64, -62, -61, -59,
+    -58, -56, -55, -53, -52, -50, -49, -47, -46, -44, -43, -41,
+    -40, -38, -37, -35, -34, -32, -31, -29, -28, -26, -25, -23,
+    -22, -20, -19, -17, -16, -14, -13, -11, -10, -8, -7, -5,
+    -4, -2, -1, 1, 2, 4, 5, 7, 8, 10, 11, 13,
+    14, 16, 17, 19, 20, 22, 23, 25, 26, 28, 29, 31,
+    32, 34, 35, 37, 38, 40, 41, 43, 44, 46, 47, 49,
+    50, 52, 53, 55, 57, 58, 60, 61, 63, 64, 66, 67,
+    69, 70, 72, 73, 75, 76, 78, 79, 81, 82, 84, 85,
+    87, 88, 90, 91, 93, 94, 96, 97, 99, 100, 102, 103,
+    105, 106, 108, 109, 111, 112, 114, 115, 117, 118, 120, 121,
+    123, 124, 126, 127,
+};
+static int32_t letter_conv1_mult[64] = {
+    1181878792, 1880324658, 1077519905, 1981210444, 1964330479, 1600625626, 1938728660, 1624170109, 1523459908, 1795859825, 1833206178, 1725456379,
+    1143635584, 1265760707, 1392505588, 1742140337, 1154984865, 1328424829, 1881256256, 1741758035, 2063032284, 1491933520, 1387903761, 1374092427,
+    1830655585, 1238139035, 1743460962, 2096416762, 2044037948, 1947138195, 1311504516, 1094338104, 1540214722, 1103674630, 1819080534, 1987569618,
+    1596869472, 2037709533, 1133946145, 1330636082, 1318151226, 1584182257, 1216999073, 1684420744, 1138214858, 1678428805, 1204072141, 1075692822,
+    1806226202, 2122162287, 1087765364, 1264288655, 1794720140, 1138854187, 1193544126, 1293868538, 2060552921, 1924019350, 1931418337, 1614775553,
+    1175082897, 1684086759, 1583456256, 1875919586,
+};
+static int32_t letter_conv1_shift[64] = {
+    -9, -10, -9, -10, -10, -10, -10, -10, -10, -9, -10, -10,
+    -9, -9, -9, -10, -9, -9, -10, -10, -10, -9, -10, -9,
+    -9, -9, -10, -10, -10, -10, -9, -9, -10, -9, -10, -10,
+    -10, -10, -9, -9, -9, -10, -9, -10, -9, -10, -9, -9,
+    -10, -10, -9, -9, -10, -9, -9, -9, -10, -10, -10, -10,
+    -9, -10, -10, -10,
+};
+static const data_dims_t letter_conv1_input_dims = {10, 16, 32, 1};
+static const data_dims_t letter_conv1_filter_dims = {3, 3, 0, 0};
+static const data_dims_t letter_conv1_output_dims = {10, 16, 64, 1};
+static const conv_params_t letter_conv1_params = {73, 52, {1, 1}, {1, 1}, {0, 0}, {-128, 127}};
+static const quant_data_t letter_conv1_quant = {letter_conv1_shift, letter_conv1_mult};
+static const int8_t letter_lut2[256] = {
+    -128, -128, -127, -127, -126, -126, -125, -124, -124, -123, -123, -122,
+    -121, -121, -120, -120, -119, -118, -118, -117, -117, -116, -115, -115,
+    -114, -114, -113, -113, -112, -111, -111, -110, -110, -109, -108, -108,
+    -107, -107, -106, -105, -105, -104, -104, -103, -102, -102, -101, -101,
+    -100, -100, -99, -98, -98, -97, -97, -96, -95, -95, -94, -94,
+    -93, -92, -92, -91, -91, -90, -89, -89, -88, -88, -87, -87,
+    -86, -85, -85, -84, -84, -83, -82, -82, -81, -81, -80, -79,
+    -79, -78, -78, -77, -76, -76, -75, -75, -74, -73, -73, -72,
+    -72, -71, -71, -70, -69, -69, -68, -68, -67, -66, -66, -65,
+    -65, -64, -63, -63, -62, -62, -61, -60, -60, -59, -59, -58,
+    -58, -57, -56, -56, -55, -55, -54, -53, -53, -52, -52, -51,
+    -50, -50, -49, -49, -48, -47, -47, -46, -46, -45, -44, -44,
+    -43, -43, -42, -42, -41, -40, -40, -39, -39, -38, -37, -37,
+    -36, -36, -35, -34, -34, -33, -33, -32, -31, -31, -30, -30,
+    -29, -29, -28, -27, -27, -26, -26, -25, -24, -24, -23, -23,
+    -22, -20, -18, -16, -14, -12, -10, -8, -6, -4, -2, 0,
+    2, 4, 6, 8, 10, 12, 14, 15, 17, 19, 21, 23,
+    25, 27, 29, 31, 33, 35, 37, 39, 41, 43, 45, 47,
+    49, 51, 53, 55, 57, 59, 61, 63, 65, 67, 69, 71,
+    73, 75, 77, 79, 81, 83, 85, 86, 88, 90, 92, 94,
+    96, 98, 100, 102, 104, 106, 108, 110, 112, 114, 116, 118,
+    120, 122, 124, 126,
+};
+static int32_t letter_conv2_mult[128] = {
+    1080288818, 1292242831, 1919833143, 1091327682, 1545811929, 1259179956, 1083353520, 1098200173, 1251219812, 1135241883, 1983501336, 1123498453,
+    1207232928, 1208958590, 1169851952, 2137749518, 1327223030, 1296826101, 1105871705, 1370776996, 1975314072, 2091787000, 1977418346, 1170928297,
+    1473714039, 1755043451, 2128317691, 1298544460, 1227811408, 2133988379, 1470268016, 1254006740, 1534140829, 1382056056, 1777389882, 1253817199,
+    1281044347, 1939899189, 1299839678, 1488076295, 1144422324, 1191824720, 1075027016, 2044005168, 1129395672, 1509287482, 2071873034, 2143951487,
+    1317465366, 1239817179, 2042071823, 2112165807, 1345839775, 2017233083, 1500232498, 1128459157, 1180247271, 1936226165, 1874187155, 2020339722,
+    1410907204, 1147566895, 1177643406, 2000179553, 1843506798, 1132018739, 1153379179, 1579728859, 1078567986, 1953012994, 2003658913, 1346432312,
+    1182069412, 1321706543, 1535451243, 1231304433, 2085020294, 1138476100, 1643422851, 1673544243, 1196525909, 1918140465, 1219172850, 1941299603,
+    1251382495, 1458824035, 1178471073, 1100906407, 1350491958, 1138696859, 1472456752, 2110281232, 1137354638, 1125373840, 1115467158, 2135582928,
+    1389230587, 1173622162, 1379512268, 1368350067, 1442779821, 1153160541, 2065690620, 2060302182, 1249204832, 1074117006, 1126269832, 1166648481,
+    1506342465, 1293614620, 2098587160, 1361520927, 1081997517, 1763373842, 1127293284, 1139661410, 1287571682, 1331950017, 2050755617, 2060056686,
+    1279680098, 1780524911, 1361515626, 2143081176, 1445602561, 2087125628, 1206018404, 2104388843,
+};
+static int32_t letter_conv2_shift[128] = {
+    -9, -9, -10, -9, -9, -9, -9, -9, -9, -9, -10, -9,
+    -9, -9, -9, -10, -9, -9, -9, -9, -10, -10, -10, -9,
+    -9, -9, -10, -9, -9, -10, -9, -9, -9, -9, -10, -9,
+    -9, -10, -9, -9, -9, -9, -9, -10, -9, -9, -10, -10,
+    -9, -9, -10, -10, -9, -10, -9, -9, -9, -10, -10, -10,
+    -9, -9, -9, -10, -10, -9, -9, -9, -9, -10, -10, -9,
+    -9, -9, -9, -9, -10, -9, -9, -10, -9, -10, -9, -10,
+    -9, -9, -9, -9, -9, -9, -9, -10, -9, -9, -9, -10,
+    -9, -9, -9, -9, -9, -9, -10, -10, -9, -9, -9, -9,
+    -9, -9, -10, -9, -9, -9, -9, -9, -9, -9, -10, -10,
+    -9, -10, -9, -10, -9, -10, -9, -10,
+};
+static const data_dims_t letter_conv2_input_dims = {5, 8, 64, 1};
+static const data_dims_t letter_conv2_filter_dims = {3, 3, 0, 0};
+static const data_dims_t letter_conv2_output_dims = {5, 8, 128, 1};
+static const conv_params_t letter_conv2_params = {22, -1, {1, 1}, {1, 1}, {0, 0}, {-128, 127}};
+static const quant_data_t letter_conv2_quant = {letter_conv2_shift, letter_conv2_mult};
+static const int8_t letter_lut3[256] = {
+    -128, -127, -127, -126, -126, -126, -125, -125, -124, -124, -123, -123,
+    -122, -122, -121, -121, -120, -120, -120, -119, -119, -118, -118, -117,
+    -117, -116, -116, -115, -115, -114, -114, -114, -113, -113, -112, -112,
+    -111, -111, -110, -110, -109, -109, -108, -108, -108, -107, -107, -106,
+    -106, -105, -105, -104, -104, -103, -103, -102, -102, -102, -101, -101,
+    -100, -100, -99, -99, -98, -98, -97, -97, -96, -96, -96, -95,
+    -95, -94, -94, -93, -93, -92, -92, -91, -91, -90, -90, -90,
+    -89, -89, -88, -88, -87, -87, -86, -86, -85, -85, -84, -84,
+    -84, -83, -83, -82, -82, -81, -81, -80, -80, -79, -79, -78,
+    -78, -78, -77, -77, -76, -76, -75, -75, -74, -74, -73, -73,
+    -72, -72, -72, -71, -71, -70, -70, -69, -67, -66, -64, -63,
+    -61, -60, -58, -57, -55, -54, -52, -51, -49, -47, -46, -44,
+    -43, -41, -40, -38, -37, -35, -34, -32, -31, -29, -27, -26,
+    -24, -23, -21, -20, -18, -17, -15, -14, -12, -11, -9, -7,
+    -6, -4, -3, -1, 0, 2, 3, 5, 6, 8, 9, 11,
+    13, 14, 16, 17, 19, 20, 22, 23, 25, 26, 28, 29,
+    31, 32, 34, 36, 37, 39, 40, 42, 43, 45, 46, 48,
+    49, 51, 52, 54, 56, 57, 59, 60, 62, 63, 65, 66,
+    68, 69, 71, 72, 74, 76, 77, 79, 80, 82, 83, 85,
+    86, 88, 89, 91, 92, 94, 96, 97, 99, 100, 102, 103,
+    105, 106, 108, 109, 111, 112, 114, 116, 117, 119, 120, 122,
+    123, 125, 126, 127,
+};
+
+size_t letter_model_scratch_size(void)
+{
+    size_t size = 0;
+    size = std::max(size, (size_t)esp_nn_get_conv_scratch_size(&letter_conv0_input_dims, &letter_conv0_filter_dims, &letter_conv0_output_dims, &letter_conv0_params));
+    size = std::max(size, (size_t)esp_nn_get_conv_scratch_size(&letter_conv1_input_dims, &letter_conv1_filter_dims, &letter_conv1_output_dims, &letter_conv1_params));
+    size = std::max(size, (size_t)esp_nn_get_conv_scratch_size(&letter_conv2_input_dims, &letter_conv2_filter_dims, &letter_conv2_output_dims, &letter_conv2_params));
+    return size;
+}
+
+void letter_model_invoke(const int8_t *input, int8_t *output, int8_t *activations, void *scratch)
+{
+    esp_nn_set_conv_scratch_buf(scratch);
+    apply_lut(letter_lut0, input, activations + 0, 640);
+    esp_nn_conv_s8(&letter_conv0_input_dims, activations + 0, &letter_conv0_filter_dims, reinterpret_cast<const int8_t *>(model_tflite + 708), reinterpret_cast<const int32_t *>(model_tflite + 1008), &letter_conv0_output_dims, activations + 20480, &letter_conv0_params, &letter_conv0_quant);
+    apply_lut(letter_lut1, activations + 20480, activations + 20480, 20480);
+    esp_nn_max_pool_s8(activations + 20480, 20, 32, activations + 0, 10, 16, 2, 2, 2, 2, 0, 0, -128, 127, 32);
+    esp_nn_conv_s8(&letter_conv1_input_dims, activations + 0, &letter_conv1_filter_dims, reinterpret_cast<const int8_t *>(model_tflite + 1148), reinterpret_cast<const int32_t *>(model_tflite + 19592), &letter_conv1_output_dims, activations + 20480, &letter_conv1_params, &letter_conv1_quant);
+    apply_lut(letter_lut2, activations + 20480, activations + 20480, 10240);
+    esp_nn_max_pool_s8(activations + 20480, 10, 16, activations + 0, 5, 8, 2, 2, 2, 2, 0, 0, -128, 127, 64);
+    esp_nn_conv_s8(&letter_conv2_input_dims, activations + 0, &letter_conv2_filter_dims, reinterpret_cast<const int8_t *>(model_tflite + 19860), reinterpret_cast<const int32_t *>(model_tflite + 93600), &letter_conv2_output_dims, activations + 20480, &letter_conv2_params, &letter_conv2_quant);
+    apply_lut(letter_lut3, activations + 20480, activations + 20480, 5120);
+    esp_nn_max_pool_s8(activations + 20480, 5, 8, activations + 0, 2, 4, 2, 2, 2, 2, 0, 0, -128, 127, 128);
+    esp_nn_fully_connected_s8(activations + 0, 69, 1024, reinterpret_cast<const int8_t *>(model_tflite + 94124), 0, reinterpret_cast<const int32_t *>(model_tflite + 225208), activations + 20480, 128, -128, -7, 1527645885, -128, 127);
+    esp_nn_fully_connected_s8(activations + 20480, 128, 128, reinterpret_cast<const int8_t *>(model_tflite + 225732), 0, reinterpret_cast<const int32_t *>(model_tflite + 229072), activations + 0, 26, 127, -8, 1847691404, -128, 127);
+    softmax_s8(activations + 0, output, 26, 6.136934757e-01f, 1.000000000e+00f, 3.906250000e-03f, -128);
+}
+
+// ---- Modelo "number" ----
+
+static const int8_t number_lut0[256] = {
+    -128, -127, -126, -126, -124, -123, -122, -121, -120, -120, -118, -117,
+    -116, -115, -114, -114, -112, -111, -110, -109, -108, -108, -106, -105,
+    -104, -103, -101, -101, -100, -99, -98, -97, -97, -95, -94, -93,
+    -92, -91, -91, -89, -88, -87, -86, -85, -85, -83, -82, -81,
+    -80, -79, -79, -77, -76, -75, -74, -72, -72, -71, -70, -69,
+    -68, -68, -66, -65, -64, -63, -62, -62, -60, -59, -58, -57,
+    -56, -56, -54, -53, -52, -51, -50, -50, -48, -47, -46, -45,
+    -43, -43, -42, -41, -40, -39, -37, -37, -36, -35, -34, -33,
+    -33, -31, -30, -29, -28, -27, -27, -25, -24, -23, -22, -21,
+    -21, -19, -18, -17, -16, -14, -14, -13, -12, -11, -10, -8,
+    -8, -7, -6, -5, -4, -4, -2, -1, 0, 1, 2, 2,
+    4, 5, 6, 7, 8, 8, 10, 11, 12, 13, 15, 15,
+    16, 17, 18, 19, 21, 21, 22, 23, 24, 25, 25, 27,
+    28, 29, 30, 31, 31, 33, 34, 35, 36, 37, 37, 39,
+    40, 41, 42, 43, 43, 45, 46, 47, 48, 50, 50, 51,
+    52, 53, 54, 54, 56, 57, 58, 59, 60, 60, 62, 63,
+    64, 65, 66, 66, 68, 69, 70, 71, 72, 72, 74, 75,
+    76, 77, 79, 79, 80, 81, 82, 83, 85, 85, 86, 87,
+    88, 89, 89, 91, 92, 93, 94, 95, 95, 97, 98, 99,
+    100, 101, 101, 103, 104, 105, 106, 108, 108, 109, 110, 111,
+    112, 114, 114, 115, 116, 117, 118, 118, 120, 121, 122, 123,
+    124, 124, 126, 127,
+};
+static int32_t number_conv0_mult[32] = {
+    1361957077, 1209665395, 1125890640, 1828312521, 1386658793, 1375600368, 1161106699, 1087504742, 2092473950, 1164562406, 2037183376, 1619972512,
+    1495664285, 1173701440, 1888550484, 1808837856, 1286319903, 1106078263, 1680531393, 1337930968, 1162220510, 1851500009, 1895050618, 1907105294,
+    1447944758, 2100207007, 1259520448, 1255114767, 1464617052, 1078407329, 1411137528, 1497900669,
+};
+static int32_t number_conv0_shift[32] = {
+    -10, -8, -7, -8, -8, -11, -8, -7, -8, -7, -10, -8,
+    -8, -7, -8, -9, -10, -7, -9, -7, -10, -9, -8, -8,
+    -8, -11, -10, -10, -9, -7, -8, -8,
+};
+static const data_dims_t number_conv0_input_dims = {20, 32, 1, 1};
+static const data_dims_t number_conv0_filter_dims = {3, 3, 0, 0};
+static const data_dims_t number_conv0_output_dims = {20, 32, 32, 1};
+static const conv_params_t number_conv0_params = {75, -128, {1, 1}, {1, 1}, {0, 0}, {-128, 127}};
+static const quant_data_t number_conv0_quant = {number_conv0_shift, number_conv0_mult};
+static int32_t number_conv1_mult[32] = {
+    1419456759, 1800872355, 2094508345, 1372443626, 1894302646, 1385170763, 1887073822, 1111596582, 1082086268, 1258471925, 1877769316, 1331291916,
+    1591936596, 1555253192, 1466285824, 1308272367, 1256265161, 1469295353, 2111010459, 1161034870, 1099248222, 1182801954, 1746479222, 1161293448,
+    1260948510, 1750695289, 1708341346, 1647367509, 1486966689, 1329566428, 1699708522, 1725939248,
+};
+static int32_t number_conv1_shift[32] = {
+    -10, -8, -8, -7, -8, -7, -8, -7, -7, -7, -8, -10,
+    -8, -8, -7, -10, -10, -7, -8, -7, -7, -7, -8, -7,
+    -10, -8, -7, -7, -10, -7, -10, -8,
+};
+static const data_dims_t number_conv1_input_dims = {10, 16, 32, 1};
+static const data_dims_t number_conv1_filter_dims = {3, 3, 0, 0};
+static const data_dims_t number_conv1_output_dims = {10, 16, 32, 1};
+static const conv_params_t number_conv1_params = {128, -128, {1, 1}, {1, 1}, {0, 0}, {-128, 127}};
+static const quant_data_t number_conv1_quant = {number_conv1_shift, number_conv1_mult};
+static int32_t number_conv2_mult[32] = {
+    1530756350, 1132352028, 2085082434, 1710181871, 1404579717, 1370560906, 1210917735, 1768940772, 1138191381, 1798153942, 1499767379, 1570324731,
+    1445304929, 1342564976, 1950581982, 1198501156, 1360040104, 1213591096, 1952424479, 1236362962, 1497499100, 1500479570, 1255919083, 1219405610,
+    1471787242, 1617985565, 1634092888, 1261498475, 1219594583, 1836508762, 1854870411, 1961860818,
+};
+static int32_t number_conv2_shift[32] = {
+    -9, -7, -10, -7, -7, -7, -7, -10, -6, -7, -7, -8,
+    -7, -7, -9, -7, -7, -9, -7, -7, -7, -9, -7, -7,
+    -7, -7, -7, -7, -7, -7, -7, -7,
+};
+static const data_dims_t number_conv2_input_dims = {5, 8, 32, 1};
+static const data_dims_t number_conv2_filter_dims = {3, 3, 0, 0};
+static const data_dims_t number_conv2_output_dims = {5, 8, 32, 1};
+static const conv_params_t number_conv2_params = {128, -128, {1, 1}, {1, 1}, {0, 0}, {-128, 127}};
+static const quant_data_t number_conv2_quant = {number_conv2_shift, number_conv2_mult};
+
+size_t number_model_scratch_size(void)
+{
+    size_t size = 0;
+    size = std::max(size, (size_t)esp_nn_get_conv_scratch_size(&number_conv0_input_dims, &number_conv0_filter_dims, &number_conv0_output_dims, &number_conv0_params));
+    size = std::max(size, (size_t)esp_nn_get_conv_scratch_size(&number_conv1_input_dims, &number_conv1_filter_dims, &number_conv1_output_dims, &number_conv1_params));
+    size = std::max(size, (size_t)esp_nn_get_conv_scratch_size(&number_conv2_input_dims, &number_conv2_filter_dims, &number_conv2_output_dims, &number_conv2_params));
+    return size;
+}
+
+void number_model_invoke(const int8_t *input, int8_t *output, int8_t *activations, void *scratch)
+{
+    esp_nn_set_conv_scratch_buf(scratch);
+    apply_lut(number_lut0, input, activations + 0, 640);
+    esp_nn_conv_s8(&number_conv0_input_dims, activations + 0, &number_conv0_filter_dims, reinterpret_cast<const int8_t *>(number_model_tflite + 708), reinterpret_cast<const int32_t *>(number_model_tflite + 1008), &number_conv0_output_dims, activations + 20480, &number_conv0_params, &number_conv0_quant);
+    esp_nn_max_pool_s8(activations + 20480, 20, 32, activations + 0, 10, 16, 2, 2, 2, 2, 0, 0, -128, 127, 32);
+    esp_nn_conv_s8(&number_conv1_input_dims, activations + 0, &number_conv1_filter_dims, reinterpret_cast<const int8_t *>(number_model_tflite + 1148), reinterpret_cast<const int32_t *>(number_model_tflite + 10376), &number_conv1_output_dims, activations + 20480, &number_conv1_params, &number_conv1_quant);
+    esp_nn_max_pool_s8(activations + 20480, 10, 16, activations + 0, 5, 8, 2, 2, 2, 2, 0, 0, -128, 127, 32);
+    esp_nn_conv_s8(&number_conv2_input_dims, activations + 0, &number_conv2_filter_dims, reinterpret_cast<const int8_t *>(number_model_tflite + 10516), reinterpret_cast<const int32_t *>(number_model_tflite + 19744), &number_conv2_output_dims, activations + 20480, &number_conv2_params, &number_conv2_quant);
+    esp_nn_max_pool_s8(activations + 20480, 5, 8, activations + 0, 2, 4, 2, 2, 2, 2, 0, 0, -128, 127, 32);
+    esp_nn_fully_connected_s8(activations + 0, 128, 256, reinterpret_cast<const int8_t *>(number_model_tflite + 19884), 0, reinterpret_cast<const int32_t *>(number_model_tflite + 52664), activations + 20480, 128, -128, -7, 1525072366, -128, 127);
+    esp_nn_fully_connected_s8(activations + 20480, 128, 128, reinterpret_cast<const int8_t *>(number_model_tflite + 53188), 0, reinterpret_cast<const int32_t *>(number_model_tflite + 69584), activations + 0, 128, -128, -7, 1745115693, -128, 127);
+    esp_nn_fully_connected_s8(activations + 0, 128, 128, reinterpret_cast<const int8_t *>(number_model_tflite + 70108), 0, reinterpret_cast<const int32_t *>(number_model_tflite + 71528), activations + 20480, 11, 127, -9, 1680713990, -128, 127);
+    softmax_s8(activations + 20480, output, 11, 3.219566941e-01f, 1.000000000e+00f, 3.906250000e-03f, -128);
+}
+
+#endif // CONFIG_PLATE_BACKEND_CODEGEN
@@ -0,0 +1,37 @@
+// Generado por tools/tflite_to_cc.py. No editar a mano.
+#ifndef CHAR_MODELS_GEN_H
+#define CHAR_MODELS_GEN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Modelo "letter": entrada 1x32x20x1 int8, salida 26 clases
+constexpr int letter_model_num_classes = 26;
+constexpr float letter_model_input_scale = 9.999990463e-01f;
+constexpr int letter_model_input_zero_point = -128;
+constexpr float letter_model_output_scale = 3.906250000e-03f;
+constexpr int letter_model_output_zero_point = -128;
+// true si la salida son logits crudos (el modelo no termina en Softmax)
+constexpr bool letter_model_output_logits = false;
+// Bytes de scratch que necesitan sus convoluciones en esp-nn
+size_t letter_model_scratch_size(void);
+// Ejecuta el modelo. `scratch` debe tener al menos letter_model_scratch_size() bytes.
+void letter_model_invoke(const int8_t *input, int8_t *output, int8_t *activations, void *scratch);
+
+// Modelo "number": entrada 1x32x20x1 int8, salida 11 clases
+constexpr int number_model_num_classes = 11;
+constexpr float number_model_input_scale = 9.999321699e-01f;
+constexpr int number_model_input_zero_point = -128;
+constexpr float number_model_output_scale = 3.906250000e-03f;
+constexpr int number_model_output_zero_point = -128;
+// true si la salida son logits crudos (el modelo no termina en Softmax)
+constexpr bool number_model_output_logits = false;
+// Bytes de scratch que necesitan sus convoluciones en esp-nn
+size_t number_model_scratch_size(void);
+// Ejecuta el modelo. `scratch` debe tener al menos number_model_scratch_size() bytes.
+void number_model_invoke(const int8_t *input, int8_t *output, int8_t *activations, void *scratch);
+
+// Buffer de activaciones que sirve a cualquiera de los modelos (nunca corren a la vez)
+constexpr size_t char_models_activation_size = 40960;
+
+#endif // CHAR_MODELS_GEN_H
@@ -76,17 +76,28 @@ static camera_config_t camera_config = {
 
 
 esp_err_t init_camera() {
+    // Se llama en cada captura; la cámara se inicializa una sola vez
+    static bool initialized = false;
+    if (initialized) {
+        return ESP_OK;
+    }
     esp_err_t err = esp_camera_init(&camera_config);
     if (err != ESP_OK) {
         ESP_LOGE(CAMERA_TAG, "Error inicializando la cámara: %d", err);
         return err;
     }
+    initialized = true;
     ESP_LOGI(CAMERA_TAG, "Cámara inicializada correctamente");
     return ESP_OK;
 }
 
 // Inicialización de la SD
 void init_sd() {
+    // Se llama en cada imagen; la SD se monta una sola vez
+    static bool mounted = false;
+    if (mounted) {
+        return;
+    }
     sdmmc_host_t host = SDMMC_HOST_DEFAULT();
     sdmmc_slot_config_t slot_config = SDMMC_SLOT_CONFIG_DEFAULT();
     esp_vfs_fat_sdmmc_mount_config_t mount_config = {
@@ -100,6 +111,7 @@ void init_sd() {
         ESP_LOGE(IMAGE_TAG, "Failed to mount SD card, error code: %d", err);
         return;
     }
+    mounted = true;
     ESP_LOGI(IMAGE_TAG, "SD card mounted successfully.");
 }
 
@@ -0,0 +1,37 @@
+#ifndef BINARY_MORPHOLOGY_H
+#define BINARY_MORPHOLOGY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Imagen binaria de 1 bit por píxel para la morfología después de Canny: el
+// bit x % 32 de la palabra x / 32 de cada fila es el píxel x. Los bits que
+// sobran al final de cada fila quedan siempre en cero.
+struct BinaryImage {
+    int width = 0;
+    int height = 0;
+    int words_per_row = 0;
+    uint32_t* words = nullptr;
+    size_t capacity = 0; // palabras reservadas
+};
+
+// Fija las dimensiones; solo reserva memoria si no alcanza la que ya tiene
+bool binary_image_reserve(BinaryImage& image, int width, int height);
+void binary_image_release(BinaryImage& image);
+
+// De 8 bits (distinto de cero es 1) a bits, con las dimensiones de `image`
+void binary_pack(const uint8_t* src, size_t src_stride, BinaryImage& image);
+// De bits a 8 bits (0 o 255)
+void binary_unpack(const BinaryImage& image, uint8_t* dst, size_t dst_stride);
+
+// Morfología con 32 píxeles por operación, con el mismo resultado que
+// cv::dilate / cv::erode / cv::morphologyEx con el borde por defecto (los
+// píxeles de afuera no cuentan). El kernel 3x2 es Mat::ones(3, 2) con el ancla
+// en (1, 1): la fila de arriba, la propia y la de abajo, y la columna propia y
+// la de la izquierda. Todas operan en el lugar.
+void binary_dilate_3x3(BinaryImage& image);
+void binary_dilate_3x2(BinaryImage& image);
+void binary_erode_3x2(BinaryImage& image);
+void binary_close_3x2(BinaryImage& image);
+
+#endif // BINARY_MORPHOLOGY_H
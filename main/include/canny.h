@@ -0,0 +1,26 @@
+#ifndef CANNY_H
+#define CANNY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Detector de bordes de Canny en aritmética entera para imágenes de un canal de
+// 8 bits, con la misma semántica que cv::Canny(src, dst, low, high) con apertura
+// 3 y norma L1: Sobel 3x3 en int16 con borde replicado, magnitud |dx| + |dy|,
+// dirección cuantizada a 4 sectores con tan(22.5°) en Q15, y histéresis con
+// conectividad 8.
+//
+// El espacio de trabajo (tres filas de gradientes y la pila de la histéresis)
+// se reserva una vez con canny_reserve; canny_edges no reserva memoria.
+
+// Reserva el espacio de trabajo para imágenes de hasta width x height. Solo
+// vuelve a reservar si alguna dimensión supera lo reservado, y entonces toma el
+// máximo de cada una entre lo anterior y lo pedido.
+bool canny_reserve(int width, int height);
+
+// Escribe en `dst` 255 en los bordes y 0 en el resto. `dst` puede ser `src`.
+// Devuelve false si la imagen supera lo reservado con canny_reserve.
+bool canny_edges(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride, int width, int height,
+                 int low_threshold, int high_threshold);
+
+#endif // CANNY_H
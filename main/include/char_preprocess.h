@@ -0,0 +1,44 @@
+#ifndef CHAR_PREPROCESS_H
+#define CHAR_PREPROCESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Región de un carácter dentro de la imagen (8 bits, un canal) de la patente
+struct CharCrop {
+    const uint8_t* base;  // primer píxel de la imagen de la patente
+    size_t stride;        // bytes por fila de la imagen
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// Ancho máximo de destino de crop_resize_quantize (coeficientes en la pila)
+constexpr int kCropMaxDstWidth = 64;
+
+// Recorta, redimensiona (bilineal, aproximadamente como cv::resize INTER_LINEAR:
+// mismas coordenadas y pesos, pero OpenCV trunca los valores intermedios y
+// algunos píxeles difieren en ±1) y desplaza cada píxel por `zero_shift` en una
+// sola pasada, escribiendo directamente en `dst` (dst_width * dst_height bytes,
+// sin buffers intermedios).
+// Devuelve false sin escribir nada si dst_width supera kCropMaxDstWidth.
+bool crop_resize_quantize(const CharCrop& crop, int8_t* dst, int dst_width, int dst_height, int zero_shift);
+
+// Hash perceptual del recorte: la región se divide en una grilla de 8x16 celdas
+// y cada bit indica si el brillo medio de su celda supera el de todo el recorte.
+// Recortes casi idénticos (ruido, pequeños cambios de iluminación) dan hashes a
+// pocos bits de distancia.
+constexpr int kCropHashCols = 8;
+constexpr int kCropHashRows = 16;
+
+struct CropHash {
+    uint64_t bits[kCropHashCols * kCropHashRows / 64];
+};
+
+CropHash crop_hash(const CharCrop& crop);
+
+// Cantidad de bits distintos entre dos hashes
+int crop_hash_distance(const CropHash& a, const CropHash& b);
+
+#endif // CHAR_PREPROCESS_H
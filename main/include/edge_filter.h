@@ -0,0 +1,20 @@
+#ifndef EDGE_FILTER_H
+#define EDGE_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Suavizado que preserva bordes por transformada de dominio recursiva (filtro
+// RF de Gastal y Oliveira) en aritmética entera, como alternativa rápida al
+// bilateral antes de Canny. Cada iteración hace una pasada recursiva de ida y
+// vuelta por filas y otra por columnas; el peso entre vecinos sale de una tabla
+// de 256 entradas indexada por su diferencia de gris en la imagen original, así
+// que un borde fuerte corta el suavizado y una zona pareja se promedia.
+//
+// `sigma_space` es el radio de suavizado en píxeles, `sigma_color` la diferencia
+// de gris a partir de la cual se considera borde. `dst` no puede ser `src`: la
+// imagen original guía todas las pasadas.
+void domain_transform_filter(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                             int width, int height, int sigma_space, int sigma_color, int iterations);
+
+#endif // EDGE_FILTER_H
@@ -0,0 +1,26 @@
+#ifndef GAUSSIAN_BLUR_H
+#define GAUSSIAN_BLUR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Desenfoque gaussiano 5x5 (kernel [1 4 6 4 1] / 16 por eje) para imágenes de
+// un canal de 8 bits, con borde BORDER_REFLECT_101. Da el mismo resultado, bit
+// a bit, que cv::GaussianBlur(src, dst, Size(5, 5), 0) en CV_8UC1: las sumas
+// son enteras y se redondean una sola vez al final.
+//
+// Procesa una fila por vez con un buffer de una fila de sumas verticales y dos
+// píxeles por palabra de 32 bits. El buffer se reserva en la primera llamada y
+// se reutiliza; solo crece si llega una imagen más ancha. `dst` no puede ser
+// `src`. Devuelve false si no pudo reservar el buffer de fila.
+bool gaussian_blur_5x5(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride, int width,
+                       int height);
+
+// Igual, pero calcula solo las filas [first_row, first_row + row_count) de la
+// imagen de `height` filas y las deja desde la primera fila de `dst`. Las filas
+// vecinas de `src` se usan como borde, así que una franja da lo mismo que el
+// recorte de la imagen completa.
+bool gaussian_blur_5x5_rows(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride, int width,
+                            int height, int first_row, int row_count);
+
+#endif // GAUSSIAN_BLUR_H
@@ -0,0 +1,46 @@
+#ifndef INFERENCE_WORKER_H
+#define INFERENCE_WORKER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "char_preprocess.h"
+#include "tf_model.h"
+
+// Tarea de inferencia fijada al otro núcleo (CONFIG_PLATE_INFERENCE_WORKER).
+// El pipeline le envía las lecturas de cada patente apenas termina de
+// segmentarla y sigue con el frame siguiente (pasos 1 a 10) mientras la tarea
+// las clasifica; después las recoge con inference_worker_collect.
+
+// Lecturas de una patente. Los recortes (y la imagen a la que apuntan),
+// `is_letter` y las salidas deben seguir vivos hasta recogerla.
+struct InferenceJob {
+    const CharCrop* crops;
+    const bool* is_letter;
+    size_t count;
+    char* predictions;
+    float* confidences;
+    CharTopK* top_k;
+    TaskHandle_t owner;      // tarea a la que se avisa al terminar
+    uint32_t run_us;         // duración de run_model_batch en la tarea
+    std::atomic<bool> done;
+};
+
+// Crea la cola y la tarea. Los modelos ya deben estar inicializados: a partir
+// de aquí solo la tarea de inferencia los usa.
+bool inference_worker_start();
+
+bool inference_worker_running();
+
+// Encola la patente (espera si ya hay CONFIG_PLATE_INFERENCE_QUEUE_LEN en la
+// cola). Devuelve false si la tarea no está activa: la patente no se clasificó
+// y quien llama puede usar run_model_batch en su núcleo.
+bool inference_worker_submit(InferenceJob* job);
+
+// Espera a que la tarea termine `job`. Las patentes se pueden recoger en
+// cualquier orden, pero solo desde la tarea que las envió.
+void inference_worker_collect(InferenceJob* job);
+
+#endif // INFERENCE_WORKER_H
@@ -0,0 +1,27 @@
+#ifndef INPUT_STAGER_H
+#define INPUT_STAGER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "char_preprocess.h"
+
+// Tarea de preparación de entradas fijada a un núcleo (CONFIG_PLATE_INPUT_STAGING).
+// Mientras el motor ejecuta el Invoke de un carácter, esta tarea recorta,
+// redimensiona y cuantiza el siguiente en un buffer de staging del motor.
+// Hay un solo trabajo en vuelo: cada input_stager_begin va seguido de un
+// input_stager_wait antes del próximo.
+
+bool input_stager_start();
+
+bool input_stager_running();
+
+// Encola la preparación de `count` recortes, uno tras otro en `dst`
+// (dst_width * dst_height bytes cada uno). Vuelve sin esperar.
+bool input_stager_begin(const CharCrop* const* crops, size_t count, int8_t* dst, int dst_width, int dst_height,
+                        int zero_shift);
+
+// Espera a que termine el trabajo encolado por input_stager_begin. Devuelve
+// false si algún recorte no se pudo preparar (ver crop_resize_quantize).
+bool input_stager_wait();
+
+#endif // INPUT_STAGER_H
@@ -0,0 +1,61 @@
+#ifndef MODEL_PARTITION_H
+#define MODEL_PARTITION_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Formato de la partición de modelos (ver tools/pack_models.py). Al inicio va
+// una cabecera con una entrada por modelo; cada flatbuffer sigue alineado a 16
+// bytes. Todos los campos son little-endian.
+#define MODEL_PARTITION_MAGIC 0x444D4C50 // "PLMD"
+#define MODEL_PARTITION_FORMAT_VERSION 1
+#define MODEL_PARTITION_MAX_MODELS 8
+#define MODEL_PARTITION_NAME_LEN 16
+#define MODEL_PARTITION_CLASS_MAP_LEN 40
+
+struct ModelPartitionEntry
+{
+    char name[MODEL_PARTITION_NAME_LEN]; // "letter", "number", "letter-fast", ...
+    uint32_t version;                    // versión del modelo (para A/B en la flota)
+    uint32_t offset;                     // desde el inicio de la partición
+    uint32_t size;
+    uint32_t crc32;                      // CRC-32 (IEEE) del flatbuffer
+    uint16_t input_width;
+    uint16_t input_height;
+    uint16_t input_channels;
+    uint16_t num_classes;
+    char class_map[MODEL_PARTITION_CLASS_MAP_LEN]; // carácter de cada clase, terminado en '\0'
+};
+
+struct ModelPartitionHeader
+{
+    uint32_t magic;
+    uint16_t format_version;
+    uint16_t model_count;
+    uint32_t entries_crc32; // CRC-32 de las model_count entradas
+    uint32_t reserved;
+    ModelPartitionEntry entries[MODEL_PARTITION_MAX_MODELS];
+};
+
+// Un modelo listo para el intérprete: `data` apunta a la flash mapeada (o al
+// array compilado) sin copias
+struct ModelBlob
+{
+    const unsigned char *data;
+    size_t size;
+    uint32_t version;
+    int input_width;
+    int input_height;
+    int input_channels;
+    int num_classes;
+    const char *class_map;
+};
+
+// Mapea la partición CONFIG_PLATE_MODEL_PARTITION_LABEL y valida la cabecera y
+// el CRC de cada modelo. Se llama una vez al arrancar.
+bool model_partition_open();
+
+// Busca un modelo validado por nombre. Devuelve false si no está en la partición.
+bool model_partition_find(const char *name, ModelBlob *blob);
+
+#endif // MODEL_PARTITION_H
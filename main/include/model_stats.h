@@ -0,0 +1,54 @@
+#ifndef MODEL_STATS_H
+#define MODEL_STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Estadísticas de inferencia por modelo en memoria (CONFIG_PLATE_RUNTIME_STATS).
+// Solo la tarea que ejecuta los modelos las actualiza, sin locks ni logs; otras
+// tareas (la consola serie, un reporte periódico) leen una copia consistente
+// en cualquier momento.
+
+constexpr int kModelStatsMaxModels = 10;
+
+struct ModelStats
+{
+    const char *name;
+    uint32_t invokes;
+    uint32_t chars;       // recortes clasificados por esos Invokes
+    uint32_t min_us;
+    uint32_t mean_us;
+    uint32_t p95_us;      // estimado con un histograma de ~19% de resolución
+    uint32_t max_us;
+    // Arena que el intérprete planificó en el setup (o buffer del código
+    // generado). TFLM reserva todo en AllocateTensors, así que no cambia al
+    // invocar: no es un máximo medido en ejecución.
+    uint32_t setup_arena_bytes;
+    uint32_t cache_hits;  // recortes de este modelo resueltos por la caché
+};
+
+// Da de alta un modelo al terminar su setup. Devuelve su id, o -1 si no hay lugar.
+int model_stats_register(const char *name, size_t setup_arena_bytes);
+// Libera el slot de un modelo que se desactivó después de registrarse (ignora
+// ids negativos). El próximo registro lo reutiliza.
+void model_stats_unregister(int id);
+
+// Llamadas desde la tarea de inferencia; ignoran ids negativos
+void model_stats_record_invoke(int id, uint32_t elapsed_us, int chars);
+void model_stats_record_cache_hits(int id, int hits);
+
+// Copia hasta `max` modelos en `out` y devuelve cuántos copió. Se puede llamar
+// desde cualquier tarea.
+size_t model_stats_get(ModelStats *out, size_t max);
+
+// Pone los contadores en cero. Desde otra tarea el reset se aplica en la
+// próxima actualización; hasta entonces el modelo se informa en cero.
+void model_stats_reset();
+
+// Imprime la tabla por stdout (enteros, sin formato de punto flotante)
+void model_stats_print();
+
+// Registra el comando `model_stats [reset]` en la consola de ESP-IDF
+bool model_stats_register_console_command();
+
+#endif // MODEL_STATS_H
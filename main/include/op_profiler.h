@@ -0,0 +1,51 @@
+#ifndef OP_PROFILER_H
+#define OP_PROFILER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "tensorflow/lite/micro/micro_profiler_interface.h"
+
+// Perfil por operador de un modelo: el intérprete abre y cierra un evento por
+// cada op que ejecuta, y aquí se acumulan los ticks por capa (posición de la op
+// dentro del Invoke) a lo largo de muchas invocaciones. No depende de ESP-IDF,
+// así que sirve igual en el build de Linux para comparar kernels.
+class OpProfiler : public tflite::MicroProfilerInterface
+{
+public:
+    static constexpr int kMaxLayers = 48;
+
+    explicit OpProfiler(const char *model_name);
+
+    uint32_t BeginEvent(const char *tag) override;
+    void EndEvent(uint32_t event_handle) override;
+
+    // Llamar antes de cada Invoke: la siguiente op vuelve a ser la capa 0
+    void BeginInvoke();
+    void Reset();
+
+    uint32_t invokes() const { return invokes_; }
+
+    // Tabla legible con tiempo medio/mínimo/máximo y porcentaje por capa
+    void LogTable() const;
+    // Una fila CSV por capa: model,layer,op,invokes,avg_us,min_us,max_us,total_ticks
+    void LogCsv(bool header) const;
+
+private:
+    struct LayerStats
+    {
+        const char *tag;
+        uint64_t total_ticks;
+        uint32_t min_ticks;
+        uint32_t max_ticks;
+        uint32_t count;
+    };
+
+    const char *model_name_;
+    LayerStats layers_[kMaxLayers];
+    uint32_t begin_ticks_[kMaxLayers];
+    int num_layers_;
+    int next_layer_;
+    uint32_t invokes_;
+};
+
+#endif // OP_PROFILER_H
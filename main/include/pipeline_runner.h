@@ -9,6 +9,7 @@
 
 #include <stddef.h> // Agrega esta línea
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,8 +17,46 @@ extern "C" {
 
 void run_pipeline(uint8_t* input_data, size_t input_size, const char* format);
 
+// run_pipeline en dos tiempos, para solapar frames: run_pipeline_begin segmenta
+// la imagen y deja sus caracteres clasificándose en el otro núcleo
+// (CONFIG_PLATE_INFERENCE_WORKER), y run_pipeline_finish espera la patente más
+// antigua y registra su lectura. Entre uno y otro se puede capturar y segmentar
+// el frame siguiente. run_pipeline_begin devuelve false si no quedó nada que
+// terminar (imagen inválida o dos patentes sin terminar).
+bool run_pipeline_begin(uint8_t* input_data, size_t input_size, const char* format);
+void run_pipeline_finish(void);
+
 #ifdef __cplusplus
 }
+
+#include <string>
+
+namespace cv {
+class Mat;
+}
+
+// Suavizado que preserva bordes antes de Canny (Paso 4)
+enum class EdgeFilter {
+    Bilateral,        // cv::bilateralFilter, d=9
+    DomainTransform,  // transformada de dominio recursiva entera (edge_filter.h)
+};
+
+// Filtro elegido en menuconfig (CONFIG_PLATE_EDGE_FILTER)
+EdgeFilter default_edge_filter();
+
+// Paso 4 con el filtro indicado
+void apply_edge_filter(const cv::Mat &input_mat, cv::Mat &output_mat, EdgeFilter filter);
+
+// Pasos 1 a 10 y la clasificación sobre una imagen ya cargada; devuelve la
+// lectura de la patente (vacía si no se encontró ninguna). run_pipeline la usa
+// con default_edge_filter().
+std::string recognize_plate(cv::Mat &input_mat, EdgeFilter filter);
+
+// recognize_plate en dos tiempos (ver run_pipeline_begin): begin_plate hace los
+// pasos 1 a 10 y envía la clasificación, finish_plate devuelve la lectura de la
+// patente más antigua sin terminar. Como mucho dos patentes en vuelo.
+bool begin_plate(cv::Mat &input_mat, EdgeFilter filter);
+std::string finish_plate();
 #endif
 
 #endif // PIPELINE_RUNNER_H
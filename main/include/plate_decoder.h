@@ -0,0 +1,43 @@
+#ifndef PLATE_DECODER_H
+#define PLATE_DECODER_H
+
+#include <stddef.h>
+#include "tf_model.h"
+
+// Decodificación conjunta del formato de la patente (CONFIG_PLATE_JOINT_DECODER).
+// Cada región segmentada trae sus mejores clases como letra y como dígito; se
+// elige, en una sola pasada, el formato argentino válido (LLL NNN o LL NNN LL)
+// y la asignación de regiones de mayor log-probabilidad. Las regiones que no
+// entran en el formato se descartan con una penalización fija, así una mancha
+// extra o un carácter partido no obligan a capturar otro cuadro.
+
+enum class PlateFormat {
+    None,
+    Old,  // 1994: LLL NNN
+    New,  // 2016: LL NNN LL
+};
+
+constexpr size_t kMaxPlateChars = 7;
+
+// Puntajes de una región con ambos modelos
+struct BlobScores {
+    CharTopK letter;
+    CharTopK digit;
+};
+
+struct PlateDecode {
+    PlateFormat format;
+    char text[kMaxPlateChars + 1];      // terminado en '\0'
+    size_t length;
+    size_t blob_index[kMaxPlateChars];  // región usada en cada posición
+    size_t dropped;                     // regiones descartadas
+    float score;                        // log-probabilidad total, con penalizaciones
+    float min_confidence;
+};
+
+// Devuelve false si no hay regiones suficientes para ningún formato.
+bool decode_plate(const BlobScores* blobs, size_t count, PlateDecode* result);
+
+const char* plate_format_name(PlateFormat format);
+
+#endif // PLATE_DECODER_H
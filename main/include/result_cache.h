@@ -0,0 +1,39 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "char_preprocess.h"
+#include "tf_model.h"
+
+// Caché LRU de resultados por recorte (CONFIG_PLATE_RESULT_CACHE). Con un auto
+// detenido frente a la barrera la misma patente llega cuadro tras cuadro: un
+// recorte cuyo hash perceptual queda a pocos bits de uno ya clasificado para el
+// mismo tipo de posición (letra o dígito) reutiliza su clase, su confianza y sus
+// alternativas (top-k) sin Invoke.
+
+struct ResultCacheStats
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t insertions;
+    uint32_t evictions;
+};
+
+// Busca el recorte más parecido dentro de la distancia configurada. Cuenta un
+// acierto o un fallo. `top_k` puede ser nulo.
+bool result_cache_lookup(const CropHash &hash, bool is_letter, char *result, float *confidence,
+                         CharTopK *top_k = nullptr);
+
+// Guarda una clasificación con sus alternativas; los resultados con confianza
+// menor al mínimo configurado no se guardan. Si la caché está llena reemplaza
+// la entrada usada hace más tiempo.
+void result_cache_insert(const CropHash &hash, bool is_letter, char result, float confidence,
+                         const CharTopK &top_k);
+
+ResultCacheStats result_cache_stats();
+void result_cache_reset_stats();
+// Vacía la caché, por ejemplo al cambiar de modelo
+void result_cache_clear();
+
+#endif // RESULT_CACHE_H
@@ -3,7 +3,37 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include "char_preprocess.h"
+
+// Clases alternativas que se informan por carácter
+constexpr int kCharTopK = 3;
+
+// Las clases más probables de un recorte con el modelo de su posición, de mayor
+// a menor probabilidad. Las posiciones sin clase quedan en '\0' con probabilidad 0.
+struct CharTopK {
+    char classes[kCharTopK];
+    float probs[kCharTopK];
+};
+
+bool init_models();
+
+// Bytes de arena efectivamente usados por el modelo de letras o de números
+size_t model_arena_used_bytes(bool is_letter);
 
 void run_model(bool is_letter, uint8_t* input_buffer, char* result);
 
+// Clasifica todos los caracteres de una patente en una sola llamada. Cada región
+// se recorta y redimensiona a 20x32 directamente en el tensor de entrada.
+// `is_letter[i]` indica el modelo de cada posición y `results[i]` recibe su carácter.
+// Se hace un Invoke por modelo cuando el modelo se exportó con batch >= cantidad de recortes.
+// Si `confidences` no es nulo, recibe la probabilidad (softmax) de cada carácter elegido.
+// Si `top_k` no es nulo, `top_k[i]` recibe las clases más probables de cada recorte.
+void run_model_batch(const CharCrop* crops, const bool* is_letter, size_t count, char* results,
+                     float* confidences = nullptr, CharTopK* top_k = nullptr);
+
+// Perfil por operador acumulado desde el arranque o el último reset
+// (CONFIG_PLATE_OP_PROFILE): tabla legible o CSV por el log.
+void model_profile_dump(bool csv);
+void model_profile_reset();
+
 #endif 
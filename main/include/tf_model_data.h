@@ -2,4 +2,27 @@
 extern const unsigned char number_model_tflite[];
 extern const unsigned int number_model_tflite_len;
 extern const unsigned char model_tflite[];
-extern const unsigned int model_tflite_len;
\ No newline at end of file
+extern const unsigned int model_tflite_len;
+
+// Modelos rápidos opcionales para la cascada (CONFIG_PLATE_CASCADE). Se declaran
+// débiles: si ningún archivo los define, su dirección es nula.
+extern const unsigned char letter_fast_model_tflite[] __attribute__((weak));
+extern const unsigned int letter_fast_model_tflite_len __attribute__((weak));
+extern const unsigned char number_fast_model_tflite[] __attribute__((weak));
+extern const unsigned int number_fast_model_tflite_len __attribute__((weak));
+
+// Pares cabeza/cola opcionales de modelos con salida temprana
+// (CONFIG_PLATE_EARLY_EXIT), débiles como los modelos rápidos
+extern const unsigned char letter_head_model_tflite[] __attribute__((weak));
+extern const unsigned int letter_head_model_tflite_len __attribute__((weak));
+extern const unsigned char letter_tail_model_tflite[] __attribute__((weak));
+extern const unsigned int letter_tail_model_tflite_len __attribute__((weak));
+extern const unsigned char number_head_model_tflite[] __attribute__((weak));
+extern const unsigned int number_head_model_tflite_len __attribute__((weak));
+extern const unsigned char number_tail_model_tflite[] __attribute__((weak));
+extern const unsigned int number_tail_model_tflite_len __attribute__((weak));
+
+// Modelo combinado opcional de 36 clases (CONFIG_PLATE_COMBINED_MODEL), débil
+// como los modelos rápidos
+extern const unsigned char plate_model_tflite[] __attribute__((weak));
+extern const unsigned int plate_model_tflite_len __attribute__((weak));
@@ -0,0 +1,99 @@
+#include "inference_worker.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "tf_model.h"
+
+#define WORKER_TAG "INFERENCE_WORKER"
+
+#if CONFIG_PLATE_INFERENCE_WORKER
+
+static QueueHandle_t job_queue = nullptr;
+static TaskHandle_t worker_task = nullptr;
+
+// Clasifica cada patente de la cola con una sola llamada a run_model_batch
+static void inference_worker_task(void *pvParameters) {
+    for (;;) {
+        InferenceJob *job;
+        if (xQueueReceive(job_queue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        int64_t start_time = esp_timer_get_time();
+        run_model_batch(job->crops, job->is_letter, job->count, job->predictions, job->confidences, job->top_k);
+        job->run_us = (uint32_t)(esp_timer_get_time() - start_time);
+
+        // Después de avisar, `job` ya puede no existir
+        TaskHandle_t owner = job->owner;
+        job->done.store(true, std::memory_order_release);
+        xTaskNotifyGive(owner);
+    }
+}
+
+bool inference_worker_start() {
+    if (worker_task != nullptr) {
+        return true;
+    }
+
+    job_queue = xQueueCreate(CONFIG_PLATE_INFERENCE_QUEUE_LEN, sizeof(InferenceJob *));
+    if (job_queue == nullptr) {
+        ESP_LOGE(WORKER_TAG, "Failed to create inference queue");
+        return false;
+    }
+
+    if (xTaskCreatePinnedToCore(inference_worker_task, "inference_worker", CONFIG_PLATE_INFERENCE_WORKER_STACK_SIZE,
+                                NULL, CONFIG_PLATE_INFERENCE_WORKER_PRIORITY, &worker_task,
+                                CONFIG_PLATE_INFERENCE_WORKER_CORE) != pdPASS) {
+        ESP_LOGE(WORKER_TAG, "Failed to create inference task");
+        worker_task = nullptr;
+        return false;
+    }
+
+    ESP_LOGI(WORKER_TAG, "Inference worker running on core %d", CONFIG_PLATE_INFERENCE_WORKER_CORE);
+    return true;
+}
+
+bool inference_worker_running() {
+    return worker_task != nullptr;
+}
+
+bool inference_worker_submit(InferenceJob* job) {
+    if (worker_task == nullptr) {
+        return false;
+    }
+
+    job->owner = xTaskGetCurrentTaskHandle();
+    job->done.store(false, std::memory_order_relaxed);
+    return xQueueSend(job_queue, &job, portMAX_DELAY) == pdTRUE;
+}
+
+void inference_worker_collect(InferenceJob* job) {
+    // La tarea siempre termina cada patente encolada (con '\0' si falla el
+    // Invoke), por eso se puede esperar sin timeout: la imagen del frame no se
+    // libera mientras la tarea todavía la lee. Un aviso de otra patente solo
+    // hace volver a mirar `done`.
+    while (!job->done.load(std::memory_order_acquire)) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+#else
+
+bool inference_worker_start() {
+    return false;
+}
+
+bool inference_worker_running() {
+    return false;
+}
+
+bool inference_worker_submit(InferenceJob*) {
+    return false;
+}
+
+void inference_worker_collect(InferenceJob*) {
+}
+
+#endif // CONFIG_PLATE_INFERENCE_WORKER
@@ -0,0 +1,109 @@
+#include "input_stager.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#define STAGER_TAG "INPUT_STAGER"
+
+#if CONFIG_PLATE_INPUT_STAGING
+
+struct StageJob {
+    const CharCrop* const* crops;
+    size_t count;
+    int8_t* dst;
+    int dst_width;
+    int dst_height;
+    int zero_shift;
+};
+
+static QueueHandle_t job_queue = nullptr;
+static SemaphoreHandle_t job_done = nullptr;
+static TaskHandle_t stager_task = nullptr;
+// Resultado del último trabajo; se lee después de tomar job_done
+static bool job_prepared = false;
+
+static void input_stager_task(void *pvParameters) {
+    StageJob job;
+    for (;;) {
+        if (xQueueReceive(job_queue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        size_t image_size = (size_t)job.dst_width * job.dst_height;
+        bool prepared = true;
+        for (size_t i = 0; i < job.count; i++) {
+            prepared &= crop_resize_quantize(*job.crops[i], job.dst + i * image_size, job.dst_width,
+                                             job.dst_height, job.zero_shift);
+        }
+        if (!prepared) {
+            ESP_LOGE(STAGER_TAG, "Crop destination %dx%d not supported", job.dst_width, job.dst_height);
+        }
+        job_prepared = prepared;
+        xSemaphoreGive(job_done);
+    }
+}
+
+bool input_stager_start() {
+    if (stager_task != nullptr) {
+        return true;
+    }
+
+    job_queue = xQueueCreate(1, sizeof(StageJob));
+    job_done = xSemaphoreCreateBinary();
+    if (job_queue == nullptr || job_done == nullptr) {
+        ESP_LOGE(STAGER_TAG, "Failed to create staging queue");
+        return false;
+    }
+
+    if (xTaskCreatePinnedToCore(input_stager_task, "input_stager", CONFIG_PLATE_INPUT_STAGING_STACK_SIZE, NULL,
+                                CONFIG_PLATE_INPUT_STAGING_PRIORITY, &stager_task,
+                                CONFIG_PLATE_INPUT_STAGING_CORE) != pdPASS) {
+        ESP_LOGE(STAGER_TAG, "Failed to create staging task");
+        stager_task = nullptr;
+        return false;
+    }
+
+    ESP_LOGI(STAGER_TAG, "Input staging running on core %d", CONFIG_PLATE_INPUT_STAGING_CORE);
+    return true;
+}
+
+bool input_stager_running() {
+    return stager_task != nullptr;
+}
+
+bool input_stager_begin(const CharCrop* const* crops, size_t count, int8_t* dst, int dst_width, int dst_height,
+                        int zero_shift) {
+    if (stager_task == nullptr) {
+        return false;
+    }
+
+    StageJob job = {crops, count, dst, dst_width, dst_height, zero_shift};
+    return xQueueSend(job_queue, &job, portMAX_DELAY) == pdTRUE;
+}
+
+bool input_stager_wait() {
+    xSemaphoreTake(job_done, portMAX_DELAY);
+    return job_prepared;
+}
+
+#else
+
+bool input_stager_start() {
+    return false;
+}
+
+bool input_stager_running() {
+    return false;
+}
+
+bool input_stager_begin(const CharCrop* const*, size_t, int8_t*, int, int, int) {
+    return false;
+}
+
+bool input_stager_wait() {
+    return false;
+}
+
+#endif // CONFIG_PLATE_INPUT_STAGING
@@ -14,8 +14,15 @@
 #include <nvs.h>
 #include <esp_system.h>
 #include "pipeline_runner.h"
+#include "tf_model.h"
+#include "inference_worker.h"
 #include <esp_timer.h>
 #include "esp_heap_trace.h"
+#include "sdkconfig.h"
+#if CONFIG_PLATE_STATS_CONSOLE
+#include "esp_console.h"
+#include "model_stats.h"
+#endif
 
 // #define NUM_RECORDS 100
 // static heap_trace_record_t trace_record[NUM_RECORDS]; 
@@ -30,27 +37,85 @@ size_t file_size = 0;
 void start_pipeline(void *pvParameters)
 {    
     const char* format = "BMP";
-    if (USE_SD_IMAGE) {
-        ESP_LOGI(TAG, "Cargando imagen desde SD...");
-        load_image_from_sd(DIRECTORY_PATH, &input_data, &file_size);
-        format = (strrchr(DIRECTORY_PATH, '.')) + 1;
-    } else {
-        ESP_LOGI(TAG, "Capturando imagen con la cámara...");
-        capture_image_from_camera(&input_data, &file_size);
+
+    // Construir los intérpretes una sola vez, antes de procesar imágenes
+    if (!init_models()) {
+        ESP_LOGE(TAG, "No se pudieron inicializar los modelos");
+    }
+#if CONFIG_PLATE_INFERENCE_WORKER
+    else if (!inference_worker_start()) {
+        ESP_LOGW(TAG, "Tarea de inferencia no disponible, se clasifica en este núcleo");
     }
+#endif
+
+    // Cada frame se segmenta mientras el anterior se clasifica en el otro
+    // núcleo; su lectura se registra después de empezar el siguiente
+    bool pending = false;
+    for (int frame = 0; CONFIG_PLATE_CAPTURE_FRAMES == 0 || frame < CONFIG_PLATE_CAPTURE_FRAMES; frame++) {
+        if (USE_SD_IMAGE) {
+            ESP_LOGI(TAG, "Cargando imagen desde SD...");
+            load_image_from_sd(DIRECTORY_PATH, &input_data, &file_size);
+            format = (strrchr(DIRECTORY_PATH, '.')) + 1;
+        } else {
+            ESP_LOGI(TAG, "Capturando imagen con la cámara...");
+            capture_image_from_camera(&input_data, &file_size);
+        }
 
-    run_pipeline(input_data, file_size, format);
+        // La patente guarda su propio recorte: la imagen ya se puede liberar
+        bool started = run_pipeline_begin(input_data, file_size, format);
+        free(input_data);
+        input_data = nullptr;
+        file_size = 0;
+
+        if (pending) {
+            run_pipeline_finish();
+        }
+        pending = started;
+    }
+    if (pending) {
+        run_pipeline_finish();
+    }
     ESP_LOGI(TAG, "Pipeline finalizado exitosamente");
 
-    free(input_data);
     vTaskDelete(NULL);
 }
 
+#if CONFIG_PLATE_STATS_CONSOLE
+// Consola serie para consultar las estadísticas de inferencia en equipos
+// instalados sin subir el nivel de log
+static void start_console()
+{
+    esp_console_repl_t *repl = nullptr;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = "plate>";
+    esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    if (esp_console_new_repl_uart(&uart_config, &repl_config, &repl) != ESP_OK) {
+        ESP_LOGW(TAG, "No se pudo crear la consola serie");
+        return;
+    }
+    esp_console_register_help_command();
+    model_stats_register_console_command();
+    if (esp_console_start_repl(repl) != ESP_OK) {
+        ESP_LOGW(TAG, "No se pudo iniciar la consola serie");
+    }
+}
+#endif
+
 extern "C" void app_main()
 {
     //ESP_ERROR_CHECK( heap_trace_init_standalone(trace_record, NUM_RECORDS) );
 
+#if CONFIG_PLATE_STATS_CONSOLE
+    start_console();
+#endif
+
+#if CONFIG_PLATE_INFERENCE_WORKER
+    // El pipeline queda en el núcleo libre y la inferencia en el suyo
+    xTaskCreatePinnedToCore(start_pipeline, "start_pipeline", 16 * 1024, NULL, 8, NULL,
+                            1 - CONFIG_PLATE_INFERENCE_WORKER_CORE);
+#else
     xTaskCreate(start_pipeline, "start_pipeline", 16 * 1024, NULL, 8, NULL);
+#endif
     vTaskDelete(NULL);
 }
 
@@ -0,0 +1,159 @@
+#include "model_partition.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "sdkconfig.h"
+
+#define PARTITION_TAG "MODEL_PARTITION"
+
+#if CONFIG_PLATE_MODEL_SOURCE_PARTITION
+
+static const ModelPartitionHeader *header = nullptr;
+static const uint8_t *partition_base = nullptr;
+static size_t partition_size = 0;
+static bool entry_valid[MODEL_PARTITION_MAX_MODELS];
+
+static bool validate_entry(const ModelPartitionEntry &entry)
+{
+    if (memchr(entry.name, '\0', sizeof(entry.name)) == nullptr ||
+        memchr(entry.class_map, '\0', sizeof(entry.class_map)) == nullptr)
+    {
+        ESP_LOGE(PARTITION_TAG, "Entry with unterminated name or class map");
+        return false;
+    }
+    if (entry.offset % 16 != 0 || entry.offset < sizeof(ModelPartitionHeader) || entry.size == 0 ||
+        entry.offset > partition_size || entry.size > partition_size - entry.offset)
+    {
+        ESP_LOGE(PARTITION_TAG, "Model %s out of bounds (offset %u, size %u)", entry.name, (unsigned)entry.offset,
+                 (unsigned)entry.size);
+        return false;
+    }
+    if (strlen(entry.class_map) != entry.num_classes)
+    {
+        ESP_LOGE(PARTITION_TAG, "Model %s: class map has %d entries, expected %d", entry.name,
+                 (int)strlen(entry.class_map), entry.num_classes);
+        return false;
+    }
+
+    uint32_t crc = esp_rom_crc32_le(0, partition_base + entry.offset, entry.size);
+    if (crc != entry.crc32)
+    {
+        ESP_LOGE(PARTITION_TAG, "Model %s checksum mismatch (0x%08x != 0x%08x)", entry.name, (unsigned)crc,
+                 (unsigned)entry.crc32);
+        return false;
+    }
+    return true;
+}
+
+bool model_partition_open()
+{
+    if (header != nullptr)
+    {
+        return true;
+    }
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                                CONFIG_PLATE_MODEL_PARTITION_LABEL);
+    if (partition == nullptr)
+    {
+        ESP_LOGE(PARTITION_TAG, "Partition '%s' not found", CONFIG_PLATE_MODEL_PARTITION_LABEL);
+        return false;
+    }
+
+    // Mapear toda la partición: el intérprete lee los pesos directamente de flash
+    const void *mapped = nullptr;
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &mapped, &handle);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(PARTITION_TAG, "Failed to mmap '%s': %s", partition->label, esp_err_to_name(err));
+        return false;
+    }
+    partition_base = static_cast<const uint8_t *>(mapped);
+    partition_size = partition->size;
+
+    const ModelPartitionHeader *candidate = reinterpret_cast<const ModelPartitionHeader *>(partition_base);
+    if (partition_size < sizeof(ModelPartitionHeader) || candidate->magic != MODEL_PARTITION_MAGIC)
+    {
+        ESP_LOGE(PARTITION_TAG, "Partition '%s' has no model header (flash it with tools/pack_models.py)",
+                 partition->label);
+        esp_partition_munmap(handle);
+        return false;
+    }
+    if (candidate->format_version != MODEL_PARTITION_FORMAT_VERSION ||
+        candidate->model_count > MODEL_PARTITION_MAX_MODELS)
+    {
+        ESP_LOGE(PARTITION_TAG, "Unsupported model partition (format %u, %u models)",
+                 (unsigned)candidate->format_version, (unsigned)candidate->model_count);
+        esp_partition_munmap(handle);
+        return false;
+    }
+    uint32_t crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t *>(candidate->entries),
+                                    candidate->model_count * sizeof(ModelPartitionEntry));
+    if (crc != candidate->entries_crc32)
+    {
+        ESP_LOGE(PARTITION_TAG, "Model partition header checksum mismatch");
+        esp_partition_munmap(handle);
+        return false;
+    }
+
+    // Un modelo corrupto solo invalida su entrada; el motor decide si le hace falta
+    for (int i = 0; i < candidate->model_count; i++)
+    {
+        const ModelPartitionEntry &entry = candidate->entries[i];
+        entry_valid[i] = validate_entry(entry);
+        if (entry_valid[i])
+        {
+            ESP_LOGI(PARTITION_TAG, "Model %s v%u: %u bytes, input %ux%ux%u, %u classes", entry.name,
+                     (unsigned)entry.version, (unsigned)entry.size, entry.input_width, entry.input_height,
+                     entry.input_channels, entry.num_classes);
+        }
+    }
+
+    // La partición queda mapeada mientras dure el programa
+    header = candidate;
+    return true;
+}
+
+bool model_partition_find(const char *name, ModelBlob *blob)
+{
+    if (header == nullptr)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < header->model_count; i++)
+    {
+        const ModelPartitionEntry &entry = header->entries[i];
+        if (!entry_valid[i] || strncmp(entry.name, name, sizeof(entry.name)) != 0)
+        {
+            continue;
+        }
+
+        blob->data = partition_base + entry.offset;
+        blob->size = entry.size;
+        blob->version = entry.version;
+        blob->input_width = entry.input_width;
+        blob->input_height = entry.input_height;
+        blob->input_channels = entry.input_channels;
+        blob->num_classes = entry.num_classes;
+        blob->class_map = entry.class_map;
+        return true;
+    }
+    return false;
+}
+
+#else
+
+bool model_partition_open()
+{
+    return false;
+}
+
+bool model_partition_find(const char *, ModelBlob *)
+{
+    return false;
+}
+
+#endif // CONFIG_PLATE_MODEL_SOURCE_PARTITION
@@ -0,0 +1,324 @@
+#include "model_stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#if CONFIG_PLATE_STATS_CONSOLE
+#include "esp_console.h"
+#endif
+
+#define STATS_TAG "STATS"
+
+#if CONFIG_PLATE_RUNTIME_STATS
+
+// Histograma logarítmico de tiempos: 4 buckets por octava desde 64 us hasta ~4 s
+constexpr int kFirstOctave = 6;
+constexpr int kLastOctave = 21;
+constexpr int kBuckets = 1 + (kLastOctave - kFirstOctave + 1) * 4;
+
+// Un solo escritor (la tarea de inferencia) por slot. Los lectores usan el
+// contador de secuencia: impar mientras se escribe, y si cambió durante la
+// copia se vuelve a leer.
+struct StatsSlot
+{
+    const char *name;
+    uint32_t setup_arena_bytes;
+    std::atomic<uint32_t> sequence;
+    std::atomic<bool> reset_pending;
+    std::atomic<bool> in_use;
+    uint32_t invokes;
+    uint32_t chars;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t cache_hits;
+    uint32_t histogram[kBuckets];
+};
+
+static StatsSlot slots[kModelStatsMaxModels];
+static std::atomic<int> slot_count{0};
+
+static int bucket_index(uint32_t us)
+{
+    if (us < (1u << kFirstOctave))
+    {
+        return 0;
+    }
+    int octave = 31 - __builtin_clz(us);
+    if (octave > kLastOctave)
+    {
+        return kBuckets - 1;
+    }
+    return 1 + (octave - kFirstOctave) * 4 + ((us >> (octave - 2)) & 3);
+}
+
+// Centro del bucket
+static uint32_t bucket_value(int index)
+{
+    if (index == 0)
+    {
+        return (1u << kFirstOctave) / 2;
+    }
+    int octave = kFirstOctave + (index - 1) / 4;
+    uint32_t width = 1u << (octave - 2);
+    return (4 + (index - 1) % 4) * width + width / 2;
+}
+
+static void clear_counters(StatsSlot &slot)
+{
+    slot.invokes = 0;
+    slot.chars = 0;
+    slot.min_us = 0;
+    slot.max_us = 0;
+    slot.total_us = 0;
+    slot.cache_hits = 0;
+    memset(slot.histogram, 0, sizeof(slot.histogram));
+}
+
+static void begin_write(StatsSlot &slot)
+{
+    slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (slot.reset_pending.load(std::memory_order_relaxed))
+    {
+        clear_counters(slot);
+        slot.reset_pending.store(false, std::memory_order_relaxed);
+    }
+}
+
+static void end_write(StatsSlot &slot)
+{
+    slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+int model_stats_register(const char *name, size_t setup_arena_bytes)
+{
+    // Primero un slot liberado por model_stats_unregister, si no el siguiente
+    int count = slot_count.load(std::memory_order_relaxed);
+    int id = 0;
+    while (id < count && slots[id].in_use.load(std::memory_order_relaxed))
+    {
+        id++;
+    }
+    if (id >= kModelStatsMaxModels)
+    {
+        ESP_LOGW(STATS_TAG, "No stats slot left for %s", name);
+        return -1;
+    }
+    StatsSlot &slot = slots[id];
+    slot.name = name;
+    slot.setup_arena_bytes = (uint32_t)setup_arena_bytes;
+    slot.reset_pending.store(false, std::memory_order_relaxed);
+    clear_counters(slot);
+    slot.in_use.store(true, std::memory_order_release);
+    if (id == count)
+    {
+        slot_count.store(id + 1, std::memory_order_release);
+    }
+    return id;
+}
+
+void model_stats_unregister(int id)
+{
+    if (id < 0 || id >= kModelStatsMaxModels)
+    {
+        return;
+    }
+    slots[id].in_use.store(false, std::memory_order_release);
+}
+
+void model_stats_record_invoke(int id, uint32_t elapsed_us, int chars)
+{
+    if (id < 0)
+    {
+        return;
+    }
+    StatsSlot &slot = slots[id];
+    begin_write(slot);
+    slot.min_us = slot.invokes == 0 ? elapsed_us : std::min(slot.min_us, elapsed_us);
+    slot.max_us = std::max(slot.max_us, elapsed_us);
+    slot.invokes++;
+    slot.chars += chars;
+    slot.total_us += elapsed_us;
+    slot.histogram[bucket_index(elapsed_us)]++;
+    end_write(slot);
+}
+
+void model_stats_record_cache_hits(int id, int hits)
+{
+    if (id < 0 || hits <= 0)
+    {
+        return;
+    }
+    StatsSlot &slot = slots[id];
+    begin_write(slot);
+    slot.cache_hits += hits;
+    end_write(slot);
+}
+
+// Copia consistente de un slot, ya resumida
+static void read_slot(StatsSlot &slot, ModelStats &out)
+{
+    uint32_t histogram[kBuckets];
+    uint64_t total_us;
+    uint32_t before;
+    do
+    {
+        // Si el escritor quedó a mitad de escritura en este mismo núcleo, girar
+        // sin ceder no lo deja terminar
+        while ((before = slot.sequence.load(std::memory_order_acquire)) & 1)
+        {
+            taskYIELD();
+        }
+        out.invokes = slot.invokes;
+        out.chars = slot.chars;
+        out.min_us = slot.min_us;
+        out.max_us = slot.max_us;
+        out.cache_hits = slot.cache_hits;
+        total_us = slot.total_us;
+        memcpy(histogram, slot.histogram, sizeof(histogram));
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (slot.sequence.load(std::memory_order_relaxed) != before);
+
+    if (slot.reset_pending.load(std::memory_order_relaxed))
+    {
+        out = ModelStats{};
+    }
+    out.name = slot.name;
+    out.setup_arena_bytes = slot.setup_arena_bytes;
+    if (out.invokes == 0)
+    {
+        out.mean_us = out.p95_us = 0;
+        return;
+    }
+    out.mean_us = (uint32_t)(total_us / out.invokes);
+
+    // Primer bucket que acumula el 95% de los Invokes, acotado al rango observado
+    uint32_t target = (out.invokes * 95 + 99) / 100;
+    uint32_t seen = 0;
+    int index = 0;
+    while (index < kBuckets - 1 && (seen += histogram[index]) < target)
+    {
+        index++;
+    }
+    out.p95_us = std::min(std::max(bucket_value(index), out.min_us), out.max_us);
+}
+
+size_t model_stats_get(ModelStats *out, size_t max)
+{
+    int count = slot_count.load(std::memory_order_acquire);
+    size_t copied = 0;
+    for (int i = 0; i < count && copied < max; i++)
+    {
+        if (slots[i].in_use.load(std::memory_order_acquire))
+        {
+            read_slot(slots[i], out[copied++]);
+        }
+    }
+    return copied;
+}
+
+void model_stats_reset()
+{
+    int count = slot_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++)
+    {
+        slots[i].reset_pending.store(true, std::memory_order_relaxed);
+    }
+}
+
+void model_stats_print()
+{
+    ModelStats stats[kModelStatsMaxModels];
+    size_t count = model_stats_get(stats, kModelStatsMaxModels);
+    printf("model          invokes    chars   min_us  mean_us   p95_us   max_us  setup_arena  cache\n");
+    for (size_t i = 0; i < count; i++)
+    {
+        const ModelStats &s = stats[i];
+        printf("%-12s %9u %8u %8u %8u %8u %8u %12u %6u\n", s.name, (unsigned)s.invokes, (unsigned)s.chars,
+               (unsigned)s.min_us, (unsigned)s.mean_us, (unsigned)s.p95_us, (unsigned)s.max_us,
+               (unsigned)s.setup_arena_bytes, (unsigned)s.cache_hits);
+    }
+}
+
+#else
+
+int model_stats_register(const char *, size_t)
+{
+    return -1;
+}
+
+void model_stats_unregister(int)
+{
+}
+
+void model_stats_record_invoke(int, uint32_t, int)
+{
+}
+
+void model_stats_record_cache_hits(int, int)
+{
+}
+
+size_t model_stats_get(ModelStats *, size_t)
+{
+    return 0;
+}
+
+void model_stats_reset()
+{
+}
+
+void model_stats_print()
+{
+    printf("Runtime stats disabled (CONFIG_PLATE_RUNTIME_STATS)\n");
+}
+
+#endif // CONFIG_PLATE_RUNTIME_STATS
+
+#if CONFIG_PLATE_STATS_CONSOLE
+static int model_stats_command(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0)
+    {
+        model_stats_reset();
+        printf("Model stats reset\n");
+        return 0;
+    }
+    if (argc > 1)
+    {
+        printf("usage: model_stats [reset]\n");
+        return 1;
+    }
+    model_stats_print();
+    return 0;
+}
+
+bool model_stats_register_console_command()
+{
+    const esp_console_cmd_t command = {
+        .command = "model_stats",
+        .help = "Per-model Invoke count, latency (min/mean/p95/max us), arena bytes planned at setup "
+                "and cache hits. "
+                "'model_stats reset' clears the counters.",
+        .hint = "[reset]",
+        .func = &model_stats_command,
+        .argtable = nullptr,
+    };
+    if (esp_console_cmd_register(&command) != ESP_OK)
+    {
+        ESP_LOGE(STATS_TAG, "Failed to register the model_stats command");
+        return false;
+    }
+    return true;
+}
+#else
+bool model_stats_register_console_command()
+{
+    return false;
+}
+#endif // CONFIG_PLATE_STATS_CONSOLE
@@ -0,0 +1,107 @@
+#include "op_profiler.h"
+#include <string.h>
+#include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/micro_time.h"
+
+// Convierte ticks a microsegundos; si la plataforma no tiene reloj se informan ticks
+static uint32_t ticks_to_us(uint64_t ticks)
+{
+    uint32_t per_second = tflite::ticks_per_second();
+    return per_second > 0 ? (uint32_t)(ticks * 1000000ull / per_second) : (uint32_t)ticks;
+}
+
+OpProfiler::OpProfiler(const char *model_name) : model_name_(model_name)
+{
+    Reset();
+}
+
+uint32_t OpProfiler::BeginEvent(const char *tag)
+{
+    int layer = next_layer_++;
+    if (layer >= kMaxLayers)
+    {
+        return kMaxLayers;
+    }
+
+    if (layer >= num_layers_)
+    {
+        num_layers_ = layer + 1;
+        layers_[layer].tag = tag;
+    }
+    begin_ticks_[layer] = tflite::GetCurrentTimeTicks();
+    return layer;
+}
+
+void OpProfiler::EndEvent(uint32_t event_handle)
+{
+    if (event_handle >= (uint32_t)kMaxLayers)
+    {
+        return;
+    }
+
+    uint32_t ticks = tflite::GetCurrentTimeTicks() - begin_ticks_[event_handle];
+    LayerStats &stats = layers_[event_handle];
+    stats.total_ticks += ticks;
+    stats.min_ticks = stats.count == 0 || ticks < stats.min_ticks ? ticks : stats.min_ticks;
+    stats.max_ticks = ticks > stats.max_ticks ? ticks : stats.max_ticks;
+    stats.count++;
+}
+
+void OpProfiler::BeginInvoke()
+{
+    next_layer_ = 0;
+    invokes_++;
+}
+
+void OpProfiler::Reset()
+{
+    memset(layers_, 0, sizeof(layers_));
+    num_layers_ = 0;
+    next_layer_ = 0;
+    invokes_ = 0;
+}
+
+void OpProfiler::LogTable() const
+{
+    uint64_t model_ticks = 0;
+    for (int i = 0; i < num_layers_; i++)
+    {
+        model_ticks += layers_[i].total_ticks;
+    }
+
+    MicroPrintf("Op profile %s: %u invokes, %u us per invoke", model_name_, (unsigned)invokes_,
+                (unsigned)(invokes_ > 0 ? ticks_to_us(model_ticks) / invokes_ : 0));
+    MicroPrintf("  # op                  avg_us   min_us   max_us  share");
+    for (int i = 0; i < num_layers_; i++)
+    {
+        const LayerStats &stats = layers_[i];
+        if (stats.count == 0)
+        {
+            continue;
+        }
+        unsigned share = model_ticks > 0 ? (unsigned)(stats.total_ticks * 1000 / model_ticks) : 0;
+        MicroPrintf("%3d %-18s %8u %8u %8u %3u.%u%%", i, stats.tag != nullptr ? stats.tag : "?",
+                    (unsigned)(ticks_to_us(stats.total_ticks) / stats.count), (unsigned)ticks_to_us(stats.min_ticks),
+                    (unsigned)ticks_to_us(stats.max_ticks), share / 10, share % 10);
+    }
+}
+
+void OpProfiler::LogCsv(bool header) const
+{
+    if (header)
+    {
+        MicroPrintf("model,layer,op,invokes,avg_us,min_us,max_us,total_ticks");
+    }
+    for (int i = 0; i < num_layers_; i++)
+    {
+        const LayerStats &stats = layers_[i];
+        if (stats.count == 0)
+        {
+            continue;
+        }
+        MicroPrintf("%s,%d,%s,%u,%u,%u,%u,%llu", model_name_, i, stats.tag != nullptr ? stats.tag : "?",
+                    (unsigned)stats.count, (unsigned)(ticks_to_us(stats.total_ticks) / stats.count),
+                    (unsigned)ticks_to_us(stats.min_ticks), (unsigned)ticks_to_us(stats.max_ticks),
+                    (unsigned long long)stats.total_ticks);
+    }
+}
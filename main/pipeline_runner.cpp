@@ -5,13 +5,23 @@
 #include <esp_system.h>
 #include <string>
 #include <sstream>
+#include <memory>
+#include <algorithm>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "esp_heap_caps.h"
 #include <esp_timer.h> 
 #include "tf_model.h"
+#include "inference_worker.h"
+#include "plate_decoder.h"
+#include "edge_filter.h"
+#include "gaussian_blur.h"
+#include "canny.h"
+#include "binary_morphology.h"
 #include "esp_heap_trace.h"
+#include "sdkconfig.h"
 
 #define PIPELINE_TAG "PIPELINE_RUNNER"
 
@@ -79,7 +89,18 @@ void resize_image(cv::Mat &input_mat, int new_width) {
 
 void apply_gaussian_blur(const cv::Mat &input_mat, cv::Mat &output_mat, cv::Size kernel_size = cv::Size(5, 5)) {
     int64_t start_time = esp_timer_get_time();
-    cv::GaussianBlur(input_mat, output_mat, kernel_size, 0);
+    // El 5x5 sobre gris del pipeline usa la versión entera (mismo resultado que OpenCV)
+    bool blurred = false;
+    if (kernel_size.width == 5 && kernel_size.height == 5 && input_mat.type() == CV_8UC1) {
+        output_mat.create(input_mat.size(), CV_8UC1);
+        if (output_mat.data != input_mat.data) {
+            blurred = gaussian_blur_5x5(input_mat.data, input_mat.step, output_mat.data, output_mat.step,
+                                        input_mat.cols, input_mat.rows);
+        }
+    }
+    if (!blurred) {
+        cv::GaussianBlur(input_mat, output_mat, kernel_size, 0);
+    }
     int64_t end_time = esp_timer_get_time();
 
     ESP_LOGI(PIPELINE_TAG, "Tiempo de desenfoque gaussiano (Paso 3): %.6f s", 
@@ -95,26 +116,199 @@ void apply_bilateral_filter(const cv::Mat &input_mat, cv::Mat &output_mat, int d
              (end_time - start_time) / 1000000.0);
 }
 
+void apply_domain_transform_filter(const cv::Mat &input_mat, cv::Mat &output_mat) {
+    int64_t start_time = esp_timer_get_time();
+    output_mat.create(input_mat.size(), CV_8UC1);
+    domain_transform_filter(input_mat.data, input_mat.step, output_mat.data, output_mat.step, input_mat.cols,
+                            input_mat.rows, CONFIG_PLATE_DT_SIGMA_SPACE, CONFIG_PLATE_DT_SIGMA_COLOR,
+                            CONFIG_PLATE_DT_ITERATIONS);
+    int64_t end_time = esp_timer_get_time();
+
+    ESP_LOGI(PIPELINE_TAG, "Tiempo de transformada de dominio (Paso 4): %.6f s", 
+             (end_time - start_time) / 1000000.0);
+}
+
+EdgeFilter default_edge_filter() {
+#if CONFIG_PLATE_EDGE_FILTER_DOMAIN_TRANSFORM
+    return EdgeFilter::DomainTransform;
+#else
+    return EdgeFilter::Bilateral;
+#endif
+}
+
+void apply_edge_filter(const cv::Mat &input_mat, cv::Mat &output_mat, EdgeFilter filter) {
+    if (filter == EdgeFilter::DomainTransform) {
+        apply_domain_transform_filter(input_mat, output_mat);
+    } else {
+        apply_bilateral_filter(input_mat, output_mat);
+    }
+}
+
 void apply_canny_edge_detection(cv::Mat &input_mat, double threshold1 = 75, double threshold2 = 200) {
     int64_t start_time = esp_timer_get_time();
-    cv::Canny(input_mat, input_mat, threshold1, threshold2);
+    // Versión entera con el espacio de trabajo reservado una sola vez (mismo
+    // resultado que cv::Canny, sin reservas por frame)
+    if (input_mat.type() != CV_8UC1 || !canny_reserve(input_mat.cols, input_mat.rows) ||
+        !canny_edges(input_mat.data, input_mat.step, input_mat.data, input_mat.step, input_mat.cols,
+                     input_mat.rows, (int)threshold1, (int)threshold2)) {
+        cv::Canny(input_mat, input_mat, threshold1, threshold2);
+    }
     int64_t end_time = esp_timer_get_time();
 
     ESP_LOGI(PIPELINE_TAG, "Tiempo de filtro Canny (Paso 5): %.6f s", 
              (end_time - start_time) / 1000000.0);
 }
 
-void apply_dilation(cv::Mat &input_mat, int kernel_size = 3) {
-    cv::Mat kernel = cv::Mat::ones(kernel_size, kernel_size, CV_8U);
+// Después de Canny las imágenes son binarias: la morfología se hace sobre esta
+// imagen de 1 bit por píxel, que se reserva una vez y se reutiliza
+static BinaryImage morph_image;
 
+// Dilatación 3x3 de una imagen binaria de 8 bits pasando por morph_image
+static bool dilate_binary(const cv::Mat &input_mat, cv::Mat &output_mat) {
+    if (input_mat.type() != CV_8UC1 || !binary_image_reserve(morph_image, input_mat.cols, input_mat.rows)) {
+        return false;
+    }
+    binary_pack(input_mat.data, input_mat.step, morph_image);
+    binary_dilate_3x3(morph_image);
+    output_mat.create(input_mat.size(), CV_8UC1);
+    binary_unpack(morph_image, output_mat.data, output_mat.step);
+    return true;
+}
+
+void apply_dilation(cv::Mat &input_mat, int kernel_size = 3) {
     int64_t start_time = esp_timer_get_time();
-    cv::dilate(input_mat, input_mat, kernel);
+    if (kernel_size != 3 || !dilate_binary(input_mat, input_mat)) {
+        cv::Mat kernel = cv::Mat::ones(kernel_size, kernel_size, CV_8U);
+        cv::dilate(input_mat, input_mat, kernel);
+    }
     int64_t end_time = esp_timer_get_time();
 
     ESP_LOGI(PIPELINE_TAG, "Tiempo de dilatación (Paso 6): %.6f s", 
              (end_time - start_time) / 1000000.0);
 }
 
+// Pasos 3 a 6 sobre la imagen completa; cada paso deja su resultado en PSRAM
+void preprocess_full_frame(const cv::Mat &gray_mat, cv::Mat &edges_mat, EdgeFilter filter) {
+    //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
+    // Paso 3
+    cv::Mat gaussian_mat;
+    apply_gaussian_blur(gray_mat, gaussian_mat);
+    //ESP_ERROR_CHECK( heap_trace_stop() );
+    //heap_trace_dump();
+
+    //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
+    // Paso 4
+    apply_edge_filter(gaussian_mat, edges_mat, filter);
+    //ESP_ERROR_CHECK( heap_trace_stop() );
+    //heap_trace_dump();
+
+    //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
+    // Paso 5
+    apply_canny_edge_detection(edges_mat);
+    //ESP_ERROR_CHECK( heap_trace_stop() );
+    //heap_trace_dump();
+
+    //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
+    // Paso 6
+    apply_dilation(edges_mat);
+    //ESP_ERROR_CHECK( heap_trace_stop() );
+    //heap_trace_dump();
+}
+
+#if CONFIG_PLATE_STRIP_PREPROCESS
+// Filas de margen que necesitan Sobel y la supresión de no máximos de Canny (2)
+// y la dilatación 3x3 (1)
+constexpr int kLocalHaloRows = 3;
+// Alcance de la histéresis de Canny entre franjas: un borde débil se une a uno
+// fuerte de la franja vecina solo si la cadena cruza a menos de estas filas
+constexpr int kHysteresisHaloRows = 8;
+
+static int edge_filter_halo_rows(EdgeFilter filter) {
+    if (filter == EdgeFilter::DomainTransform) {
+        // Es recursivo: a 3 sigma el aporte de las filas de afuera ya es
+        // menor al 1%
+        return 3 * CONFIG_PLATE_DT_SIGMA_SPACE;
+    }
+    return 9 / 2; // radio del bilateral (d=9)
+}
+
+static uint8_t* alloc_strip_buffer(size_t size) {
+    uint8_t* buffer = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (buffer == nullptr) {
+        ESP_LOGW(PIPELINE_TAG, "Sin RAM interna para una franja de %u bytes, se usa PSRAM", (unsigned)size);
+        buffer = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    return buffer;
+}
+
+// Pasos 3 a 6 por franjas horizontales de CONFIG_PLATE_STRIP_ROWS filas. Cada
+// franja, con sus filas de margen, pasa por el gaussiano, el filtro de bordes,
+// Canny y la dilatación alternando entre dos buffers en RAM interna, y solo sus
+// filas finales se escriben en `edges_mat`: la imagen se lee una vez de PSRAM y
+// el mapa de bordes se escribe una vez. Devuelve false si no hay memoria para
+// los buffers.
+bool preprocess_in_strips(const cv::Mat &gray_mat, cv::Mat &edges_mat, EdgeFilter filter) {
+    int64_t start_time = esp_timer_get_time();
+    const int width = gray_mat.cols;
+    const int height = gray_mat.rows;
+    const int strip_rows = CONFIG_PLATE_STRIP_ROWS;
+    const int halo = kLocalHaloRows + kHysteresisHaloRows + edge_filter_halo_rows(filter);
+    const size_t buffer_size = (size_t)std::min(height, strip_rows + 2 * halo) * width;
+
+    uint8_t* buffer_a = alloc_strip_buffer(buffer_size);
+    uint8_t* buffer_b = alloc_strip_buffer(buffer_size);
+    if (buffer_a == nullptr || buffer_b == nullptr) {
+        ESP_LOGE(PIPELINE_TAG, "No se pudieron reservar los buffers de franja, se procesa la imagen completa");
+        heap_caps_free(buffer_a);
+        heap_caps_free(buffer_b);
+        return false;
+    }
+
+    edges_mat.create(height, width, CV_8UC1);
+    bool integer_canny = canny_reserve(width, (int)(buffer_size / width));
+    cv::Mat kernel = cv::Mat::ones(3, 3, CV_8U);
+    int strips = 0;
+    for (int y0 = 0; y0 < height; y0 += strip_rows, strips++) {
+        int y1 = std::min(height, y0 + strip_rows);
+        int top = std::max(0, y0 - halo);
+        int bottom = std::min(height, y1 + halo);
+        cv::Mat strip_a(bottom - top, width, CV_8UC1, buffer_a);
+        cv::Mat strip_b(bottom - top, width, CV_8UC1, buffer_b);
+
+        // El gaussiano toma el borde de las filas vecinas de la imagen completa,
+        // así que el resultado es el mismo que sin franjas
+        if (!gaussian_blur_5x5_rows(gray_mat.data, gray_mat.step, strip_a.data, width, width, height, top,
+                                    bottom - top)) {
+            cv::GaussianBlur(gray_mat.rowRange(top, bottom), strip_a, cv::Size(5, 5), 0);
+        }
+        if (filter == EdgeFilter::DomainTransform) {
+            domain_transform_filter(strip_a.data, width, strip_b.data, width, width, bottom - top,
+                                    CONFIG_PLATE_DT_SIGMA_SPACE, CONFIG_PLATE_DT_SIGMA_COLOR,
+                                    CONFIG_PLATE_DT_ITERATIONS);
+        } else {
+            cv::bilateralFilter(strip_a, strip_b, 9, 36, 36);
+        }
+        if (!integer_canny ||
+            !canny_edges(strip_b.data, width, strip_a.data, width, width, bottom - top, 75, 200)) {
+            cv::Canny(strip_b, strip_a, 75, 200);
+        }
+        if (!dilate_binary(strip_a, strip_b)) {
+            cv::dilate(strip_a, strip_b, kernel);
+        }
+
+        memcpy(edges_mat.ptr(y0), strip_b.ptr(y0 - top), (size_t)(y1 - y0) * width);
+    }
+
+    heap_caps_free(buffer_a);
+    heap_caps_free(buffer_b);
+
+    int64_t end_time = esp_timer_get_time();
+    ESP_LOGI(PIPELINE_TAG, "Tiempo de pasos 3 a 6 en %d franjas de %d filas (+%d de margen): %.6f s",
+             strips, strip_rows, halo, (end_time - start_time) / 1000000.0);
+    return true;
+}
+#endif
+
 cv::Mat find_license_plate_candidate(const cv::Mat &input_mat) {
     int64_t start_time = esp_timer_get_time();
 
@@ -178,6 +372,15 @@ void apply_erosion(cv::Mat &input_mat) {
              (end_time - start_time) / 1000000.0);
 }
 
+void apply_erosion(BinaryImage &image) {
+    int64_t start_time = esp_timer_get_time();
+    binary_erode_3x2(image);
+    int64_t end_time = esp_timer_get_time();
+
+    ESP_LOGI(PIPELINE_TAG, "Tiempo de erosión (Paso 8): %.6f s", 
+             (end_time - start_time) / 1000000.0);
+}
+
 void apply_close(cv::Mat &input_mat) {
     cv::Mat kernel = Mat::ones(3, 2, CV_8U);
 
@@ -189,7 +392,16 @@ void apply_close(cv::Mat &input_mat) {
              (end_time - start_time) / 1000000.0);
 }
 
-void find_characters_candidate(cv::Mat &input_mat, std::vector<cv::Mat> &character_images, std::vector<cv::Rect> potential_char_rects) {
+void apply_close(BinaryImage &image) {
+    int64_t start_time = esp_timer_get_time();
+    binary_close_3x2(image);
+    int64_t end_time = esp_timer_get_time();
+
+    ESP_LOGI(PIPELINE_TAG, "Tiempo de operación de cierre (Paso 9): %.6f s", 
+             (end_time - start_time) / 1000000.0);
+}
+
+void find_characters_candidate(cv::Mat &input_mat, std::vector<cv::Rect> &potential_char_rects) {
     int64_t start_time = esp_timer_get_time();
     
     std::vector<std::vector<cv::Point>> contours_chars;
@@ -213,17 +425,8 @@ void find_characters_candidate(cv::Mat &input_mat, std::vector<cv::Mat> &charact
                   return a.x < b.x;
               });
 
-    // Recortar y redimensionar caracteres detectados
-    for (const auto& rect : potential_char_rects) {
-        cv::Mat char_crop = input_mat(rect);
-        cv::resize(char_crop, char_crop, cv::Size(20, 32));
-
-        if (!char_crop.isContinuous()) {
-            char_crop = char_crop.clone();
-        }
-
-        character_images.push_back(char_crop);
-    }
+    // El recorte y redimensionado a 20x32 se hace directamente sobre el tensor
+    // de entrada del modelo (ver crop_resize_quantize), sin copias intermedias
 
     int64_t end_time = esp_timer_get_time();
     ESP_LOGI(PIPELINE_TAG, "Tiempo de encontrar contornos de caracteres (Paso 10): %.6f s", 
@@ -240,15 +443,41 @@ bool is_letter_for_plate_format(size_t char_index, bool is_new_format) {
     }
 }
 
-void process_character_inference(bool is_letter, uint8_t* image_buffer, size_t char_index, char* predicted_result) {
-    
+void process_plate_inference(std::vector<CharCrop> &character_crops, const bool* letter_slots, std::vector<char> &predictions, std::vector<float> &confidences, std::vector<CharTopK> &top_k) {
     uint64_t start_time = esp_timer_get_time();
-    run_model(is_letter, image_buffer, predicted_result); 
+    run_model_batch(character_crops.data(), letter_slots, character_crops.size(), predictions.data(), confidences.data(), top_k.data());
     uint64_t end_time = esp_timer_get_time();
-    ESP_LOGI("TF-MODEL", "Tiempo total de ejecución del carácter %zu: %.6f segundos", 
-        char_index + 1, (end_time - start_time) / 1000000.0);
+    ESP_LOGI("TF-MODEL", "Tiempo total de ejecución de %zu caracteres: %.6f segundos",
+        character_crops.size(), (end_time - start_time) / 1000000.0);
 }
 
+#if CONFIG_PLATE_JOINT_DECODER
+// Cada región se leyó como letra (lectura 2*i) y como dígito (2*i + 1). El
+// decodificador elige el formato válido y descarta las regiones que sobran; si
+// no alcanza para ninguno, el tipo de cada posición sale de la cantidad de regiones.
+std::string decode_plate_reads(size_t total_chars, const std::vector<char> &predictions, const std::vector<CharTopK> &top_k) {
+    std::vector<BlobScores> blobs(total_chars);
+    for (size_t i = 0; i < total_chars; i++) {
+        blobs[i] = {top_k[2 * i], top_k[2 * i + 1]};
+    }
+
+    PlateDecode decoded;
+    if (decode_plate(blobs.data(), total_chars, &decoded)) {
+        ESP_LOGI(PIPELINE_TAG, "Formato %s, %d regiones descartadas, puntaje %.3f, confianza mínima de la patente: %.3f",
+                 plate_format_name(decoded.format), (int)decoded.dropped, decoded.score, decoded.min_confidence);
+        return std::string(decoded.text, decoded.length);
+    }
+
+    ESP_LOGW(PIPELINE_TAG, "Ninguna lectura válida con %d regiones", (int)total_chars);
+    bool is_new_format = (total_chars == 7);
+    std::string text;
+    for (size_t i = 0; i < total_chars; i++) {
+        text += predictions[2 * i + (is_letter_for_plate_format(i, is_new_format) ? 0 : 1)];
+    }
+    return text;
+}
+#endif
+
 void log_memory() {
     size_t free_heap_before = xPortGetFreeHeapSize();
     size_t free_spiram_before = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
@@ -259,22 +488,24 @@ void log_memory() {
     ESP_LOGI("Memory Monitor", "Free SPIRAM: %u bytes", free_spiram_before);
 }
 
-extern "C" void run_pipeline(uint8_t* input_data, size_t input_size, const char* format) {
-    ESP_LOGI(PIPELINE_TAG, "Iniciando procesamiento de filtros");
-    log_memory();
-
-    // Comprobar si los datos comprimidos son válidos
-    if (input_data == nullptr || input_size == 0 || format == nullptr) {
-        ESP_LOGE(PIPELINE_TAG, "Datos comprimidos o formato inválidos");
-        return;
-    }
-
-    //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
-    // Comprobar el formato del archivo
-    cv::Mat input_mat = load_image_by_format(format, input_data, input_size);
-    //ESP_ERROR_CHECK( heap_trace_stop() );
-    //heap_trace_dump();
-
+// Patente segmentada (pasos 1 a 10) a la espera de su clasificación. Los
+// recortes apuntan a `candidate`, que vive hasta leer la patente.
+struct PlateReads {
+    cv::Mat candidate;
+    size_t total_chars = 0;
+    std::vector<CharCrop> crops;
+    std::unique_ptr<bool[]> letter_slots;
+    std::vector<char> predictions;
+    std::vector<float> confidences;
+    std::vector<CharTopK> top_k;
+    InferenceJob job{};
+    bool on_worker = false;
+    int64_t submit_time = 0;
+};
+
+// Pasos 1 a 10: deja en `plate` los recortes de los caracteres y el modelo de
+// cada lectura
+static void segment_plate(cv::Mat &input_mat, EdgeFilter filter, PlateReads &plate) {
     //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
     // Paso 1
     apply_grayscale(input_mat);
@@ -287,31 +518,15 @@ extern "C" void run_pipeline(uint8_t* input_data, size_t input_size, const char*
     //ESP_ERROR_CHECK( heap_trace_stop() );
     //heap_trace_dump();
 
-    //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
-    // Paso 3
-    cv::Mat gaussian_mat;
-    apply_gaussian_blur(input_mat, gaussian_mat);
-    //ESP_ERROR_CHECK( heap_trace_stop() );
-    //heap_trace_dump();
-
-    //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
-    // Paso 4
+    // Pasos 3 a 6: mapa de bordes dilatado
     cv::Mat input_mat_copy;
-    apply_bilateral_filter(gaussian_mat, input_mat_copy);
-    //ESP_ERROR_CHECK( heap_trace_stop() );
-    //heap_trace_dump();
-
-    //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
-    // Paso 5
-    apply_canny_edge_detection(input_mat_copy);
-    //ESP_ERROR_CHECK( heap_trace_stop() );
-    //heap_trace_dump();
-
-    //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
-    // Paso 6
-    apply_dilation(input_mat_copy);
-    //ESP_ERROR_CHECK( heap_trace_stop() );
-    //heap_trace_dump();
+#if CONFIG_PLATE_STRIP_PREPROCESS
+    if (!preprocess_in_strips(input_mat, input_mat_copy, filter)) {
+        preprocess_full_frame(input_mat, input_mat_copy, filter);
+    }
+#else
+    preprocess_full_frame(input_mat, input_mat_copy, filter);
+#endif
 
     //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
     // Paso 7
@@ -319,27 +534,39 @@ extern "C" void run_pipeline(uint8_t* input_data, size_t input_size, const char*
     //ESP_ERROR_CHECK( heap_trace_stop() );
     //heap_trace_dump();
 
-    // Vector para almacenar las imágenes en memoria
-    std::vector<cv::Mat> character_images;
+    // Regiones de los caracteres dentro de best_candidate_mat
     std::vector<cv::Rect> potential_char_rects;
     
     if (!best_candidate_mat.empty()) {
 
-        //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
-        // Paso 8
-        apply_erosion(best_candidate_mat);
-        //ESP_ERROR_CHECK( heap_trace_stop() );
-        //heap_trace_dump();
-
-        //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
-        // Paso 9
-        apply_close(best_candidate_mat);
-        //ESP_ERROR_CHECK( heap_trace_stop() );
-        //heap_trace_dump();
+        if (binary_image_reserve(morph_image, best_candidate_mat.cols, best_candidate_mat.rows)) {
+            // Los pasos 8 y 9 van seguidos sobre la imagen de 1 bit por píxel:
+            // se empaqueta y se desempaqueta una sola vez
+            binary_pack(best_candidate_mat.data, best_candidate_mat.step, morph_image);
+
+            //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
+            // Paso 8
+            apply_erosion(morph_image);
+            //ESP_ERROR_CHECK( heap_trace_stop() );
+            //heap_trace_dump();
+
+            //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
+            // Paso 9
+            apply_close(morph_image);
+            //ESP_ERROR_CHECK( heap_trace_stop() );
+            //heap_trace_dump();
+
+            binary_unpack(morph_image, best_candidate_mat.data, best_candidate_mat.step);
+        } else {
+            // Paso 8
+            apply_erosion(best_candidate_mat);
+            // Paso 9
+            apply_close(best_candidate_mat);
+        }
     
         //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
         // Paso 10
-        find_characters_candidate(best_candidate_mat, character_images, potential_char_rects);
+        find_characters_candidate(best_candidate_mat, potential_char_rects);
     } else {
         ESP_LOGI(PIPELINE_TAG, "No se encontró ningún rectángulo adecuado");
     }
@@ -347,30 +574,180 @@ extern "C" void run_pipeline(uint8_t* input_data, size_t input_size, const char*
     //heap_trace_dump();
 
     // Determinar el formato de la patente (vieja o nueva)
-    size_t total_chars = character_images.size();
+    size_t total_chars = potential_char_rects.size();
     ESP_LOGI(PIPELINE_TAG, "Cantidad de caracteres encontrados: %d", total_chars);
+#if CONFIG_PLATE_JOINT_DECODER
+    // Cada región se lee como letra y como dígito: el formato se decide después,
+    // con los puntajes de ambos modelos
+    const size_t reads_per_char = 2;
+#else
     bool is_new_format = (total_chars == 7); // 7 caracteres indican formato nuevo
-    std::vector<char> predictions; 
+    const size_t reads_per_char = 1;
+#endif
+    size_t total_reads = total_chars * reads_per_char;
+    plate.candidate = best_candidate_mat;
+    plate.total_chars = total_chars;
+    plate.crops.clear();
+    plate.letter_slots.reset(new bool[total_reads]);
+
+    for (size_t i = 0; i < potential_char_rects.size(); ++i) {
+        const cv::Rect& rect = potential_char_rects[i];
+        CharCrop crop = {best_candidate_mat.data, best_candidate_mat.step, rect.x, rect.y, rect.width, rect.height};
+
+        for (size_t r = 0; r < reads_per_char; r++) {
+            plate.crops.push_back(crop);
+#if CONFIG_PLATE_JOINT_DECODER
+            plate.letter_slots[i * reads_per_char + r] = (r == 0);
+#else
+            // Determinar si es letra o número según el formato de la patente
+            plate.letter_slots[i * reads_per_char + r] = is_letter_for_plate_format(i, is_new_format);
+#endif
+        }
+    }
+}
+
+// Clasifica todos los caracteres de la patente en una sola llamada. Con la
+// tarea de inferencia activa corre en el otro núcleo y este sigue con lo que
+// venga (ver collect_plate_inference); si no, acá mismo.
+static void submit_plate_inference(PlateReads &plate) {
+    size_t total_reads = plate.crops.size();
+    plate.predictions.assign(total_reads, '\0');
+    plate.confidences.assign(total_reads, 0.0f);
+    plate.top_k.assign(total_reads, CharTopK{});
+    plate.on_worker = false;
+    if (total_reads == 0) {
+        return;
+    }
 
-    for (size_t i = 0; i < character_images.size(); ++i) {
-        const cv::Mat& char_image = character_images[i];
-        uint8_t* image_buffer = char_image.data;
+    InferenceJob &job = plate.job;
+    job.crops = plate.crops.data();
+    job.is_letter = plate.letter_slots.get();
+    job.count = total_reads;
+    job.predictions = plate.predictions.data();
+    job.confidences = plate.confidences.data();
+    job.top_k = plate.top_k.data();
+    plate.submit_time = esp_timer_get_time();
+    plate.on_worker = inference_worker_submit(&job);
+    if (!plate.on_worker) {
+        process_plate_inference(plate.crops, plate.letter_slots.get(), plate.predictions, plate.confidences, plate.top_k);
+    }
+}
 
-        // Determinar si es letra o número según el formato de la patente
-        bool is_letter = is_letter_for_plate_format(i, is_new_format);
+// Espera la patente enviada a la tarea de inferencia. De lo que tardó la
+// clasificación en el otro núcleo, solo la espera cuesta tiempo en este: el
+// resto se solapó con lo que el pipeline hizo desde el envío.
+static void collect_plate_inference(PlateReads &plate) {
+    if (!plate.on_worker) {
+        return;
+    }
+    int64_t wait_start = esp_timer_get_time();
+    inference_worker_collect(&plate.job);
+    int64_t end_time = esp_timer_get_time();
+    plate.on_worker = false;
 
-        //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
-        char predicted_result;
-        process_character_inference(is_letter, image_buffer, i, &predicted_result);
-        //ESP_ERROR_CHECK( heap_trace_stop() );
-        //heap_trace_dump();
+    double run_s = plate.job.run_us / 1000000.0;
+    double wait_s = (end_time - wait_start) / 1000000.0;
+    ESP_LOGI("TF-MODEL", "Tiempo total de ejecución de %zu caracteres: %.6f segundos en el otro núcleo (espera de resultados: %.6f s, solapado: %.6f s, desde el envío: %.6f s)",
+        plate.crops.size(), run_s, wait_s, std::max(0.0, run_s - wait_s), (end_time - plate.submit_time) / 1000000.0);
+}
 
-        // Almacenar la predicción
-        predictions.push_back(predicted_result);     
+// Lectura final de una patente ya clasificada
+static std::string read_plate(PlateReads &plate) {
+#if !CONFIG_PLATE_JOINT_DECODER
+    if (!plate.confidences.empty()) {
+        ESP_LOGI(PIPELINE_TAG, "Confianza mínima de la patente: %.3f",
+                 *std::min_element(plate.confidences.begin(), plate.confidences.end()));
     }
+#endif
 
     // Convertir el vector de predicciones en una cadena
-    std::string final_prediction(predictions.begin(), predictions.end());
+#if CONFIG_PLATE_JOINT_DECODER
+    std::string final_prediction = decode_plate_reads(plate.total_chars, plate.predictions, plate.top_k);
+#else
+    std::string final_prediction(plate.predictions.begin(), plate.predictions.end());
+#endif
+    plate.candidate.release();
+    return final_prediction;
+}
+
+// Patentes entre begin_plate y finish_plate: la que clasifica la tarea de
+// inferencia y la del frame que se está segmentando
+constexpr size_t kPlatesInFlight = 2;
+static PlateReads plates_in_flight[kPlatesInFlight];
+static size_t first_plate = 0;
+static size_t plates_pending = 0;
+
+bool begin_plate(cv::Mat &input_mat, EdgeFilter filter) {
+    if (plates_pending == kPlatesInFlight) {
+        ESP_LOGE(PIPELINE_TAG, "Ya hay %d patentes sin terminar", (int)kPlatesInFlight);
+        return false;
+    }
+    PlateReads &plate = plates_in_flight[(first_plate + plates_pending) % kPlatesInFlight];
+    segment_plate(input_mat, filter, plate);
+    submit_plate_inference(plate);
+    plates_pending++;
+    return true;
+}
+
+std::string finish_plate() {
+    if (plates_pending == 0) {
+        return std::string();
+    }
+    PlateReads &plate = plates_in_flight[first_plate];
+    first_plate = (first_plate + 1) % kPlatesInFlight;
+    plates_pending--;
+    collect_plate_inference(plate);
+    return read_plate(plate);
+}
+
+std::string recognize_plate(cv::Mat &input_mat, EdgeFilter filter) {
+    PlateReads plate;
+    segment_plate(input_mat, filter, plate);
+    submit_plate_inference(plate);
+    collect_plate_inference(plate);
+    return read_plate(plate);
+}
+
+// Comprueba y decodifica la imagen de entrada; vacía si no se pudo
+static cv::Mat load_input(uint8_t* input_data, size_t input_size, const char* format) {
+    ESP_LOGI(PIPELINE_TAG, "Iniciando procesamiento de filtros");
+    log_memory();
+
+    // Comprobar si los datos comprimidos son válidos
+    if (input_data == nullptr || input_size == 0 || format == nullptr) {
+        ESP_LOGE(PIPELINE_TAG, "Datos comprimidos o formato inválidos");
+        return cv::Mat();
+    }
+
+    //ESP_ERROR_CHECK( heap_trace_start(HEAP_TRACE_LEAKS) );
+    // Comprobar el formato del archivo
+    cv::Mat input_mat = load_image_by_format(format, input_data, input_size);
+    //ESP_ERROR_CHECK( heap_trace_stop() );
+    //heap_trace_dump();
+    return input_mat;
+}
+
+extern "C" void run_pipeline(uint8_t* input_data, size_t input_size, const char* format) {
+    cv::Mat input_mat = load_input(input_data, input_size, format);
+    if (input_mat.empty()) {
+        return;
+    }
+
+    std::string final_prediction = recognize_plate(input_mat, default_edge_filter());
+    ESP_LOGI(PIPELINE_TAG, "Predicción final: %s", final_prediction.c_str());
+    log_memory();
+}
+
+extern "C" bool run_pipeline_begin(uint8_t* input_data, size_t input_size, const char* format) {
+    cv::Mat input_mat = load_input(input_data, input_size, format);
+    if (input_mat.empty()) {
+        return false;
+    }
+    return begin_plate(input_mat, default_edge_filter());
+}
+
+extern "C" void run_pipeline_finish(void) {
+    std::string final_prediction = finish_plate();
     ESP_LOGI(PIPELINE_TAG, "Predicción final: %s", final_prediction.c_str());
     log_memory();
 }
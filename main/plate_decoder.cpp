@@ -0,0 +1,130 @@
+#include "plate_decoder.h"
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include "sdkconfig.h"
+
+// Probabilidad mínima que se le asigna a una clase: evita log(0) y acota cuánto
+// pesa un único carácter dudoso frente al resto de la patente
+constexpr float kMinProbability = 1e-4f;
+
+#if CONFIG_PLATE_JOINT_DECODER
+constexpr float kDropPenalty = CONFIG_PLATE_DECODER_DROP_PENALTY / 100.0f;
+#else
+constexpr float kDropPenalty = 0.05f;
+#endif
+
+struct FormatPattern {
+    PlateFormat format;
+    const char* slots;  // 'L' letra, 'N' dígito
+};
+
+static const FormatPattern kFormats[] = {
+    {PlateFormat::Old, "LLLNNN"},
+    {PlateFormat::New, "LLNNNLL"},
+};
+
+// Mejor clase válida para la posición dentro del top-k: el modelo de dígitos
+// también conoce ':', que nunca aparece en una patente
+static char best_valid_class(const CharTopK& top_k, bool letter, float* prob) {
+    for (int k = 0; k < kCharTopK; k++) {
+        char c = top_k.classes[k];
+        bool valid = letter ? (c >= 'A' && c <= 'Z') : (c >= '0' && c <= '9');
+        if (valid) {
+            *prob = top_k.probs[k] > kMinProbability ? top_k.probs[k] : kMinProbability;
+            return c;
+        }
+    }
+    *prob = kMinProbability;
+    return '?';
+}
+
+// Alinea las regiones (en orden de izquierda a derecha) con las posiciones del
+// formato: cada región ocupa la siguiente posición o se descarta
+static bool decode_format(const BlobScores* blobs, size_t count, const FormatPattern& pattern,
+                          PlateDecode* result) {
+    size_t slots = strlen(pattern.slots);
+    if (count < slots) {
+        return false;
+    }
+
+    const float drop_cost = logf(kDropPenalty);
+    const float lowest = -INFINITY;
+    // score[i][j]: mejor puntaje habiendo visto i regiones y llenado j posiciones
+    std::vector<float> score((count + 1) * (slots + 1), lowest);
+    std::vector<uint8_t> used((count + 1) * (slots + 1), 0);
+    auto at = [slots](size_t i, size_t j) { return i * (slots + 1) + j; };
+
+    score[at(0, 0)] = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j <= slots && j <= i; j++) {
+            float current = score[at(i, j)];
+            if (current == lowest) {
+                continue;
+            }
+            if (current + drop_cost > score[at(i + 1, j)]) {
+                score[at(i + 1, j)] = current + drop_cost;
+                used[at(i + 1, j)] = 0;
+            }
+            if (j < slots) {
+                bool letter = pattern.slots[j] == 'L';
+                float prob;
+                best_valid_class(letter ? blobs[i].letter : blobs[i].digit, letter, &prob);
+                float candidate = current + logf(prob);
+                if (candidate > score[at(i + 1, j + 1)]) {
+                    score[at(i + 1, j + 1)] = candidate;
+                    used[at(i + 1, j + 1)] = 1;
+                }
+            }
+        }
+    }
+
+    // Reconstruir de atrás hacia adelante qué región ocupa cada posición
+    result->format = pattern.format;
+    result->length = slots;
+    result->dropped = count - slots;
+    result->score = score[at(count, slots)];
+    result->min_confidence = 1.0f;
+    result->text[slots] = '\0';
+    size_t j = slots;
+    for (size_t i = count; i > 0; i--) {
+        if (!used[at(i, j)]) {
+            continue;
+        }
+        j--;
+        bool letter = pattern.slots[j] == 'L';
+        float prob;
+        result->text[j] = best_valid_class(letter ? blobs[i - 1].letter : blobs[i - 1].digit, letter, &prob);
+        result->blob_index[j] = i - 1;
+        result->min_confidence = prob < result->min_confidence ? prob : result->min_confidence;
+    }
+    return true;
+}
+
+bool decode_plate(const BlobScores* blobs, size_t count, PlateDecode* result) {
+    bool found = false;
+    for (const FormatPattern& pattern : kFormats) {
+        PlateDecode candidate;
+        if (decode_format(blobs, count, pattern, &candidate) && (!found || candidate.score > result->score)) {
+            *result = candidate;
+            found = true;
+        }
+    }
+    if (!found) {
+        result->format = PlateFormat::None;
+        result->text[0] = '\0';
+        result->length = 0;
+    }
+    return found;
+}
+
+const char* plate_format_name(PlateFormat format) {
+    switch (format) {
+    case PlateFormat::Old:
+        return "LLL NNN";
+    case PlateFormat::New:
+        return "LL NNN LL";
+    default:
+        return "ninguno";
+    }
+}
@@ -0,0 +1,143 @@
+#include "result_cache.h"
+#include <string.h>
+#include "sdkconfig.h"
+
+#if CONFIG_PLATE_RESULT_CACHE
+
+constexpr int kCacheSize = CONFIG_PLATE_RESULT_CACHE_SIZE;
+constexpr int kMaxDistance = CONFIG_PLATE_RESULT_CACHE_MAX_DISTANCE;
+constexpr float kMinConfidence = CONFIG_PLATE_RESULT_CACHE_MIN_CONFIDENCE / 100.0f;
+
+struct CacheEntry
+{
+    CropHash hash;
+    uint32_t last_used;  // 0: entrada libre
+    bool is_letter;
+    char result;
+    float confidence;
+    CharTopK top_k;
+};
+
+// Solo la tarea que ejecuta los modelos la usa, así que no necesita lock
+static CacheEntry entries[kCacheSize];
+static uint32_t clock_ticks = 0;
+static ResultCacheStats stats;
+
+// Entrada ocupada más parecida al hash (distancia <= kMaxDistance) o -1
+static int find_nearest(const CropHash &hash, bool is_letter)
+{
+    int best = -1;
+    int best_distance = kMaxDistance + 1;
+    for (int i = 0; i < kCacheSize; i++)
+    {
+        if (entries[i].last_used == 0 || entries[i].is_letter != is_letter)
+        {
+            continue;
+        }
+        int distance = crop_hash_distance(hash, entries[i].hash);
+        if (distance < best_distance)
+        {
+            best = i;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+
+bool result_cache_lookup(const CropHash &hash, bool is_letter, char *result, float *confidence, CharTopK *top_k)
+{
+    int index = find_nearest(hash, is_letter);
+    if (index < 0)
+    {
+        stats.misses++;
+        return false;
+    }
+
+    entries[index].last_used = ++clock_ticks;
+    *result = entries[index].result;
+    *confidence = entries[index].confidence;
+    if (top_k != nullptr)
+    {
+        *top_k = entries[index].top_k;
+    }
+    stats.hits++;
+    return true;
+}
+
+void result_cache_insert(const CropHash &hash, bool is_letter, char result, float confidence,
+                         const CharTopK &top_k)
+{
+    if (result == '\0' || confidence < kMinConfidence)
+    {
+        return;
+    }
+
+    // Un recorte casi idéntico ya guardado se actualiza en lugar de duplicarse
+    int index = find_nearest(hash, is_letter);
+    if (index < 0)
+    {
+        index = 0;
+        for (int i = 1; i < kCacheSize && entries[index].last_used != 0; i++)
+        {
+            if (entries[i].last_used < entries[index].last_used)
+            {
+                index = i;
+            }
+        }
+        if (entries[index].last_used != 0)
+        {
+            stats.evictions++;
+        }
+        stats.insertions++;
+    }
+
+    CacheEntry &entry = entries[index];
+    entry.hash = hash;
+    entry.last_used = ++clock_ticks;
+    entry.is_letter = is_letter;
+    entry.result = result;
+    entry.confidence = confidence;
+    entry.top_k = top_k;
+}
+
+ResultCacheStats result_cache_stats()
+{
+    return stats;
+}
+
+void result_cache_reset_stats()
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+void result_cache_clear()
+{
+    memset(entries, 0, sizeof(entries));
+    clock_ticks = 0;
+}
+
+#else
+
+bool result_cache_lookup(const CropHash &, bool, char *, float *, CharTopK *)
+{
+    return false;
+}
+
+void result_cache_insert(const CropHash &, bool, char, float, const CharTopK &)
+{
+}
+
+ResultCacheStats result_cache_stats()
+{
+    return ResultCacheStats{};
+}
+
+void result_cache_reset_stats()
+{
+}
+
+void result_cache_clear()
+{
+}
+
+#endif // CONFIG_PLATE_RESULT_CACHE
@@ -6,70 +6,356 @@
 #include <esp_task_wdt.h>
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/schema/schema_utils.h"
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/recording_micro_allocator.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <esp_timer.h>
+#include <algorithm>
+#include <ctype.h>
+#include <math.h>
+#include <memory>
+#include <new>
+#include <vector>
+#include "tf_model.h"
 #include "tf_model_data.h"
+#include "model_partition.h"
 #include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#if CONFIG_PLATE_BACKEND_CODEGEN
+#include "char_models_gen.h"
+#endif
+#if CONFIG_PLATE_OP_PROFILE
+#include "op_profiler.h"
+#endif
+#if CONFIG_PLATE_INPUT_STAGING
+#include "input_stager.h"
+#endif
+#if CONFIG_PLATE_RESULT_CACHE
+#include "result_cache.h"
+#endif
+#if CONFIG_PLATE_RUNTIME_STATS
+#include "model_stats.h"
+#endif
 
 #define IMAGE_WIDTH 20
 #define IMAGE_HEIGHT 32
 #define MODEL_TAG "MODELS"
 
-uint8_t output_buffer[IMAGE_WIDTH * IMAGE_HEIGHT];
+#if CONFIG_PLATE_RUNTIME_STATS
+// Los tiempos por Invoke quedan en model_stats; formatearlos por la UART en
+// cada carácter cuesta tiempo, así que el log pasa a nivel debug
+#define LOG_INVOKE_TIME ESP_LOGD
+#else
+#define LOG_INVOKE_TIME ESP_LOGI
+#endif
 
-constexpr int kTensorArenaSize = 44 * 1024 ;
-EXT_RAM_BSS_ATTR static uint8_t tensor_arena[kTensorArenaSize];
+constexpr int kImageSize = IMAGE_WIDTH * IMAGE_HEIGHT;
+static_assert(IMAGE_WIDTH <= kCropMaxDstWidth, "crop_resize_quantize does not support the model input width");
 
-// Declaración de los tensores y el intérprete
-tflite::ErrorReporter *error_reporter = nullptr;
-const tflite::Model *model = nullptr;
-tflite::MicroInterpreter *interpreter = nullptr;
-TfLiteTensor *input = nullptr;
-TfLiteTensor *output = nullptr;
+// Los tamaños salen de CONFIG_PLATE_ARENA_MEASURE (ver log "Arena measure")
+#if CONFIG_PLATE_BACKEND_CODEGEN
+// El código generado no usa arena: ambos modelos comparten un único buffer de
+// activaciones (más entrada, salida y scratch de esp-nn) reservado al arrancar.
+constexpr size_t kLetterArenaSize = 0;
+constexpr size_t kNumberArenaSize = 0;
+constexpr size_t kSharedArenaSize = 0;
+constexpr size_t kMaxClasses = 32;
+static int8_t *generated_activations = nullptr;
+static int8_t *generated_input = nullptr;
+static int8_t *generated_output = nullptr;
+static void *generated_scratch = nullptr;
+typedef void (*GeneratedInvoke)(const int8_t *input, int8_t *output, int8_t *activations, void *scratch);
+#elif CONFIG_PLATE_ARENA_LAYOUT_SHARED
+// Cada modelo guarda sus estructuras persistentes en su propia región y ambos
+// comparten la memoria de activaciones, ya que nunca se ejecutan a la vez.
+constexpr size_t kLetterArenaSize = CONFIG_PLATE_LETTER_PERSISTENT_ARENA_SIZE;
+constexpr size_t kNumberArenaSize = CONFIG_PLATE_NUMBER_PERSISTENT_ARENA_SIZE;
+constexpr size_t kSharedArenaSize = CONFIG_PLATE_SHARED_ARENA_SIZE;
+static uint8_t *shared_tensor_arena = nullptr;
+#else
+constexpr size_t kLetterArenaSize = CONFIG_PLATE_LETTER_ARENA_SIZE;
+constexpr size_t kNumberArenaSize = CONFIG_PLATE_NUMBER_ARENA_SIZE;
+constexpr size_t kSharedArenaSize = 0;
+#endif
 
-TfLiteStatus RegisterOps(tflite::MicroMutableOpResolver<10> &op_resolver, bool is_letter)
+#if CONFIG_PLATE_CASCADE
+#if CONFIG_PLATE_ARENA_LAYOUT_SHARED
+constexpr size_t kFastArenaSize = CONFIG_PLATE_FAST_PERSISTENT_ARENA_SIZE;
+#else
+constexpr size_t kFastArenaSize = CONFIG_PLATE_FAST_ARENA_SIZE;
+#endif
+// Por debajo de esta confianza el carácter se vuelve a clasificar con el modelo grande
+constexpr float kCascadeThreshold = CONFIG_PLATE_CASCADE_THRESHOLD / 100.0f;
+#endif
+
+#if CONFIG_PLATE_EARLY_EXIT
+#if CONFIG_PLATE_ARENA_LAYOUT_SHARED
+constexpr size_t kEarlyExitArenaSize = CONFIG_PLATE_EARLY_EXIT_PERSISTENT_ARENA_SIZE;
+#else
+constexpr size_t kEarlyExitArenaSize = CONFIG_PLATE_EARLY_EXIT_ARENA_SIZE;
+#endif
+// Por debajo de esta confianza en la cabeza de salida el carácter sigue por la cola
+constexpr float kEarlyExitThreshold = CONFIG_PLATE_EARLY_EXIT_THRESHOLD / 100.0f;
+#endif
+
+#if CONFIG_PLATE_COMBINED_MODEL
+// Clases del modelo combinado compilado cuando no viene un mapa de la partición
+static const char kCombinedClassMap[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+#endif
+
+#if CONFIG_PLATE_ARENA_MEASURE
+constexpr size_t kMeasureArenaSize = 160 * 1024;
+#endif
+
+// Dónde viven los pesos del modelo y la arena de tensores
+enum class MemoryPlacement
+{
+    Flash,
+    Psram,
+    Internal,
+};
+
+#if CONFIG_PLATE_WEIGHTS_IN_PSRAM
+constexpr MemoryPlacement kWeightsPlacement = MemoryPlacement::Psram;
+#elif CONFIG_PLATE_WEIGHTS_IN_INTERNAL_RAM
+constexpr MemoryPlacement kWeightsPlacement = MemoryPlacement::Internal;
+#else
+constexpr MemoryPlacement kWeightsPlacement = MemoryPlacement::Flash;
+#endif
+
+#if CONFIG_PLATE_ARENA_IN_INTERNAL_RAM
+constexpr MemoryPlacement kArenaPlacement = MemoryPlacement::Internal;
+#else
+constexpr MemoryPlacement kArenaPlacement = MemoryPlacement::Psram;
+#endif
+
+static const char *placement_name(MemoryPlacement placement)
+{
+    switch (placement)
+    {
+    case MemoryPlacement::Flash:
+        return "flash";
+    case MemoryPlacement::Psram:
+        return "psram";
+    default:
+        return "dram";
+    }
+}
+
+static uint32_t placement_caps(MemoryPlacement placement)
+{
+    return placement == MemoryPlacement::Internal ? (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+                                                  : (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+}
+
+static uint8_t *allocate_arena(size_t size, MemoryPlacement placement)
 {
-    TF_LITE_ENSURE_STATUS(op_resolver.AddFullyConnected());
-    TF_LITE_ENSURE_STATUS(op_resolver.AddQuantize());
-    TF_LITE_ENSURE_STATUS(op_resolver.AddReshape());
-    TF_LITE_ENSURE_STATUS(op_resolver.AddConv2D());
-    TF_LITE_ENSURE_STATUS(op_resolver.AddMaxPool2D());
-    TF_LITE_ENSURE_STATUS(op_resolver.AddSoftmax());
-    TF_LITE_ENSURE_STATUS(op_resolver.AddDequantize());
-    TF_LITE_ENSURE_STATUS(op_resolver.AddMul());
-    TF_LITE_ENSURE_STATUS(op_resolver.AddAdd());
+    return static_cast<uint8_t *>(heap_caps_aligned_alloc(16, size, placement_caps(placement)));
+}
 
-    if (is_letter)
+// Copia el flatbuffer a RAM si la política lo pide; con Flash se usa el array
+// original. Devuelve nullptr si no hay memoria suficiente en la región pedida.
+static const unsigned char *place_model_weights(const unsigned char *model_data, size_t model_size,
+                                                MemoryPlacement placement)
+{
+    if (placement == MemoryPlacement::Flash)
     {
-        TF_LITE_ENSURE_STATUS(op_resolver.AddLeakyRelu());
+        return model_data;
+    }
+
+    unsigned char *copy = static_cast<unsigned char *>(heap_caps_aligned_alloc(16, model_size, placement_caps(placement)));
+    if (copy == nullptr)
+    {
+        return nullptr;
+    }
+    memcpy(copy, model_data, model_size);
+    return copy;
+}
+
+static void release_model_weights(const unsigned char *weights, const unsigned char *model_data)
+{
+    if (weights != nullptr && weights != model_data)
+    {
+        heap_caps_free(const_cast<unsigned char *>(weights));
+    }
+}
+
+// Estado persistente de cada modelo: se construye una sola vez al arrancar
+struct ModelRuntime
+{
+    const char *name;
+    bool is_letter;
+    const unsigned char *model_data;
+    size_t model_size;
+    uint32_t model_version;
+    const char *class_map; // nullptr: 'A'+clase / '0'+clase
+    int num_classes;
+    bool is_combined;      // letras y dígitos en la misma salida
+    bool feature_input;    // cola de salida temprana: recibe rasgos, no la imagen
+    const unsigned char *weights;
+    uint8_t *tensor_arena;
+    size_t tensor_arena_size;
+
+    const tflite::Model *model;
+    tflite::MicroMutableOpResolver<10> op_resolver;
+    tflite::MicroAllocator *allocator;
+    tflite::MicroInterpreter *interpreter;
+    TfLiteTensor *input;
+    TfLiteTensor *output;
+#if CONFIG_PLATE_EARLY_EXIT
+    TfLiteTensor *features; // cabeza de salida temprana: rasgos del primer bloque
+#endif
+#if CONFIG_PLATE_BACKEND_CODEGEN
+    GeneratedInvoke generated_invoke;
+#endif
+#if CONFIG_PLATE_OP_PROFILE
+    OpProfiler *profiler;
+#endif
+#if CONFIG_PLATE_RUNTIME_STATS
+    int stats_id;
+#endif
+
+    // Vista independiente del backend de la entrada y la salida cuantizadas
+    int8_t *input_data;
+    const int8_t *output_data;
+    float output_scale;
+    int output_zero_point;
+    bool output_logits;    // sin Softmax final: la confianza se calcula al leer la salida
+    int batch_size;
+    int64_t setup_time_us;
+};
+
+// Registra solo los operadores que usa el modelo: uno exportado con la
+// normalización plegada en la primera convolución y salida en logits no carga
+// Mul/Add, Quantize/Dequantize ni Softmax
+TfLiteStatus RegisterOps(tflite::MicroMutableOpResolver<10> &op_resolver, const tflite::Model *model)
+{
+    for (const tflite::OperatorCode *code : *model->operator_codes())
+    {
+        tflite::BuiltinOperator op = tflite::GetBuiltinCode(code);
+        if (op_resolver.FindOp(op) != nullptr)
+        {
+            continue; // la misma op con otra versión
+        }
+        switch (op)
+        {
+        case tflite::BuiltinOperator_FULLY_CONNECTED:
+            TF_LITE_ENSURE_STATUS(op_resolver.AddFullyConnected());
+            break;
+        case tflite::BuiltinOperator_QUANTIZE:
+            TF_LITE_ENSURE_STATUS(op_resolver.AddQuantize());
+            break;
+        case tflite::BuiltinOperator_RESHAPE:
+            TF_LITE_ENSURE_STATUS(op_resolver.AddReshape());
+            break;
+        case tflite::BuiltinOperator_CONV_2D:
+            TF_LITE_ENSURE_STATUS(op_resolver.AddConv2D());
+            break;
+        case tflite::BuiltinOperator_MAX_POOL_2D:
+            TF_LITE_ENSURE_STATUS(op_resolver.AddMaxPool2D());
+            break;
+        case tflite::BuiltinOperator_SOFTMAX:
+            TF_LITE_ENSURE_STATUS(op_resolver.AddSoftmax());
+            break;
+        case tflite::BuiltinOperator_DEQUANTIZE:
+            TF_LITE_ENSURE_STATUS(op_resolver.AddDequantize());
+            break;
+        case tflite::BuiltinOperator_MUL:
+            TF_LITE_ENSURE_STATUS(op_resolver.AddMul());
+            break;
+        case tflite::BuiltinOperator_ADD:
+            TF_LITE_ENSURE_STATUS(op_resolver.AddAdd());
+            break;
+        case tflite::BuiltinOperator_LEAKY_RELU:
+            TF_LITE_ENSURE_STATUS(op_resolver.AddLeakyRelu());
+            break;
+        default:
+            ESP_LOGE(MODEL_TAG, "Unsupported op %s", tflite::EnumNameBuiltinOperator(op));
+            return kTfLiteError;
+        }
     }
     return kTfLiteOk;
 }
 
-// Preprocesar la imagen: normalizar los valores de los píxeles
-void preprocess_image(uint8_t *raw_data, int8_t *image_data, int width, int height, bool is_int8)
+// Un modelo que no termina en Softmax entrega logits crudos
+static bool model_outputs_logits(const tflite::Model *model)
+{
+    const tflite::SubGraph *subgraph = model->subgraphs()->Get(0);
+    const auto *operators = subgraph->operators();
+    if (operators == nullptr || operators->size() == 0)
+    {
+        return false;
+    }
+    const tflite::Operator *last = operators->Get(operators->size() - 1);
+    return tflite::GetBuiltinCode(model->operator_codes()->Get(last->opcode_index())) !=
+           tflite::BuiltinOperator_SOFTMAX;
+}
+
+static bool class_allowed(const ModelRuntime &runtime, int index, bool is_letter)
+{
+    return !runtime.is_combined || (isalpha((unsigned char)runtime.class_map[index]) != 0) == is_letter;
+}
+
+// Normalizador de una fila de salida para score_probability: con logits, la
+// suma de exponenciales del softmax sobre las clases permitidas; con el modelo
+// combinado, la suma de las probabilidades cuantizadas permitidas.
+static float score_normalizer(const ModelRuntime &runtime, const int8_t *scores, bool is_letter, int8_t max_value)
 {
-    for (int i = 0; i < width * height; i++) {
-        if (is_int8) {
-            image_data[i] = static_cast<int8_t>(raw_data[i] - 128);
-        } else {
-            image_data[i] = static_cast<uint8_t>(raw_data[i]);
+    float sum = 0.0f;
+    for (int i = 0; i < runtime.num_classes; i++)
+    {
+        if (!class_allowed(runtime, i, is_letter))
+        {
+            continue;
+        }
+        if (runtime.output_logits)
+        {
+            sum += expf((scores[i] - max_value) * runtime.output_scale);
+        }
+        else
+        {
+            sum += scores[i] - runtime.output_zero_point;
         }
     }
+    return sum;
 }
 
-void printPredictedClass(bool is_letter, char* result)
+static float score_probability(const ModelRuntime &runtime, int8_t value, int8_t max_value, float normalizer)
 {
-    int output_size = is_letter ? 26 : 11; // Tamaño de salida ajustado según si es letra o número
+    if (runtime.output_logits)
+    {
+        return expf((value - max_value) * runtime.output_scale) / normalizer;
+    }
+    if (runtime.is_combined && normalizer > 0.0f)
+    {
+        return (value - runtime.output_zero_point) / normalizer;
+    }
+    return (value - runtime.output_zero_point) * runtime.output_scale;
+}
+
+// Devuelve la confianza de la clase elegida: la salida softmax decuantizada.
+// Con el modelo combinado solo compiten las clases válidas para la posición
+// (letras o dígitos), lo que equivale a enmascarar los logits antes del softmax:
+// la confianza se renormaliza sobre las clases permitidas. Con salida en logits
+// la clase es el argmax de los int8 crudos y el softmax se aplica solo aquí.
+float printPredictedClass(const ModelRuntime &runtime, int row, bool is_letter, char* result)
+{
+    int output_size = runtime.num_classes;
+    const int8_t *scores = runtime.output_data + row * output_size;
     int8_t max_value = -128;
     int predicted_class = -1;
 
     for (int i = 0; i < output_size; i++)
     {
-        int8_t value = output->data.int8[i];
+        if (!class_allowed(runtime, i, is_letter))
+        {
+            continue;
+        }
+        int8_t value = scores[i];
         if (value > max_value)
         {
             max_value = value;
@@ -77,80 +363,1281 @@ void printPredictedClass(bool is_letter, char* result)
         }
     }
 
+    float confidence = score_probability(runtime, max_value, max_value,
+                                         score_normalizer(runtime, scores, is_letter, max_value));
+
     if (predicted_class != -1)
     {
         if (is_letter)
         {
-            char predicted_letter = 'A' + predicted_class;
+            char predicted_letter = runtime.class_map ? runtime.class_map[predicted_class] : 'A' + predicted_class;
             *result = predicted_letter; 
-            ESP_LOGI(MODEL_TAG, "The image belongs to letter: %c", predicted_letter);
+            ESP_LOGI(MODEL_TAG, "The image belongs to letter: %c (confidence %.3f)", predicted_letter, confidence);
         }
         else
         {
-            char predicted_number = '0' + predicted_class; 
+            char predicted_number = runtime.class_map ? runtime.class_map[predicted_class] : '0' + predicted_class;
             *result = predicted_number;
-            ESP_LOGI(MODEL_TAG, "The image belongs to number: %c", predicted_number);
+            ESP_LOGI(MODEL_TAG, "The image belongs to number: %c (confidence %.3f)", predicted_number, confidence);
         }
     }
     else
     {
         *result = '\0'; 
+        confidence = 0.0f;
         ESP_LOGE(MODEL_TAG, "No class predicted.");
     }
+    return confidence;
 }
 
-void run_inference(bool is_letter, const unsigned char *model_data, uint8_t* input_buffer, char* result)
+// Las kCharTopK clases más probables de la fila, con la misma máscara y
+// normalización que printPredictedClass
+static void collect_top_k(const ModelRuntime &runtime, int row, bool is_letter, CharTopK *top_k)
 {
-    // Cargar el modelo
-    int64_t start_time = esp_timer_get_time();
-    model = tflite::GetModel(model_data);
-    int64_t end_time = esp_timer_get_time();
-    ESP_LOGI(MODEL_TAG, "Model load time: %.6f s", (end_time - start_time)/ 1000000.0);
-    if (model->version() != TFLITE_SCHEMA_VERSION)
+    const int8_t *scores = runtime.output_data + row * runtime.num_classes;
+    int best[kCharTopK];
+    int found = 0;
+
+    for (int i = 0; i < runtime.num_classes; i++)
     {
-        ESP_LOGE(MODEL_TAG, "Model schema version mismatch");
-        return;
+        if (!class_allowed(runtime, i, is_letter))
+        {
+            continue;
+        }
+
+        // Inserción ordenada en la lista corta de mejores
+        int pos = found < kCharTopK ? found++ : kCharTopK;
+        while (pos > 0 && scores[best[pos - 1]] < scores[i])
+        {
+            if (pos < kCharTopK)
+            {
+                best[pos] = best[pos - 1];
+            }
+            pos--;
+        }
+        if (pos < kCharTopK)
+        {
+            best[pos] = i;
+        }
+    }
+
+    int8_t max_value = found > 0 ? scores[best[0]] : 0;
+    float normalizer = found > 0 ? score_normalizer(runtime, scores, is_letter, max_value) : 0.0f;
+    for (int k = 0; k < kCharTopK; k++)
+    {
+        if (k >= found)
+        {
+            top_k->classes[k] = '\0';
+            top_k->probs[k] = 0.0f;
+            continue;
+        }
+        top_k->classes[k] = runtime.class_map ? runtime.class_map[best[k]] : (is_letter ? 'A' : '0') + best[k];
+        top_k->probs[k] = score_probability(runtime, scores[best[k]], max_value, normalizer);
+    }
+}
+
+// Motor de inferencia: mantiene ambos intérpretes construidos y con los tensores
+// ya asignados, de modo que cada carácter solo paga preprocesado + Invoke.
+class InferenceEngine
+{
+public:
+    bool init()
+    {
+        if (ready_)
+        {
+            return true;
+        }
+
+#if CONFIG_PLATE_MODEL_SOURCE_PARTITION
+        if (!model_partition_open())
+        {
+            return false;
+        }
+#endif
+
+        describe_model(letter_, "letter", true, kLetterArenaSize);
+        describe_model(number_, "number", false, kNumberArenaSize);
+#if CONFIG_PLATE_COMBINED_MODEL
+        // Un único modelo alfanumérico sirve a todas las posiciones; si no está
+        // disponible se siguen usando los dos modelos separados
+        describe_model(combined_, "plate", true, kLetterArenaSize, true);
+        combined_active_ = combined_.model_data != nullptr;
+        if (!combined_active_)
+        {
+            ESP_LOGW(MODEL_TAG, "No combined plate model found, using letter and number models");
+        }
+#endif
+        if (!combined_active_ && (letter_.model_data == nullptr || number_.model_data == nullptr))
+        {
+            ESP_LOGE(MODEL_TAG, "Letter or number model missing");
+            return false;
+        }
+#if CONFIG_PLATE_CASCADE
+        // Los modelos rápidos son opcionales: si no se enlazaron, la cascada queda desactivada
+        describe_model(letter_fast_, "letter-fast", true, kFastArenaSize);
+        describe_model(number_fast_, "number-fast", false, kFastArenaSize);
+#endif
+#if CONFIG_PLATE_EARLY_EXIT
+        // Igual que los rápidos, los pares cabeza/cola son opcionales por modelo
+        describe_model(letter_head_, "letter-head", true, kEarlyExitArenaSize);
+        describe_model(letter_tail_, "letter-tail", true, kEarlyExitArenaSize, false, true);
+        describe_model(number_head_, "number-head", false, kEarlyExitArenaSize);
+        describe_model(number_tail_, "number-tail", false, kEarlyExitArenaSize, false, true);
+#endif
+
+#if CONFIG_PLATE_ARENA_MEASURE
+        measure_arena(letter_);
+        measure_arena(number_);
+#if CONFIG_PLATE_CASCADE
+        measure_arena(letter_fast_);
+        measure_arena(number_fast_);
+#endif
+#if CONFIG_PLATE_EARLY_EXIT
+        measure_arena(letter_head_);
+        measure_arena(letter_tail_);
+        measure_arena(number_head_);
+        measure_arena(number_tail_);
+#endif
+#if CONFIG_PLATE_COMBINED_MODEL
+        measure_arena(combined_);
+#endif
+#endif
+
+#if CONFIG_PLATE_PLACEMENT_BENCHMARK
+        benchmark_placements(letter_);
+        benchmark_placements(number_);
+#if CONFIG_PLATE_CASCADE
+        benchmark_placements(letter_fast_);
+        benchmark_placements(number_fast_);
+#endif
+#if CONFIG_PLATE_EARLY_EXIT
+        benchmark_placements(letter_head_);
+        benchmark_placements(letter_tail_);
+        benchmark_placements(number_head_);
+        benchmark_placements(number_tail_);
+#endif
+#if CONFIG_PLATE_COMBINED_MODEL
+        benchmark_placements(combined_);
+#endif
+#endif
+
+#if CONFIG_PLATE_BACKEND_CODEGEN
+        if (!allocate_generated_buffers())
+        {
+            return false;
+        }
+#endif
+
+#if CONFIG_PLATE_ARENA_LAYOUT_SHARED
+        shared_tensor_arena = allocate_arena(kSharedArenaSize, kArenaPlacement);
+        if (shared_tensor_arena == nullptr)
+        {
+            ESP_LOGE(MODEL_TAG, "Failed to allocate shared arena in %s", placement_name(kArenaPlacement));
+            return false;
+        }
+#endif
+
+#if CONFIG_PLATE_COMBINED_MODEL
+        if (combined_active_)
+        {
+            // Solo se construye el intérprete combinado: un juego de pesos y una arena
+            if (!setup_model(combined_))
+            {
+                return false;
+            }
+#if CONFIG_PLATE_INPUT_STAGING
+            setup_staging();
+#endif
+            ready_ = true;
+            return true;
+        }
+#endif
+
+        if (!setup_model(letter_) || !setup_model(number_))
+        {
+            return false;
+        }
+
+#if CONFIG_PLATE_CASCADE
+        setup_fast_model(letter_fast_);
+        setup_fast_model(number_fast_);
+#endif
+#if CONFIG_PLATE_EARLY_EXIT
+        setup_early_exit(letter_head_, letter_tail_);
+        setup_early_exit(number_head_, number_tail_);
+#endif
+#if CONFIG_PLATE_INPUT_STAGING
+        setup_staging();
+#endif
+
+        ready_ = true;
+        return true;
     }
 
-    // Configurar el intérprete y registrar operaciones
-    tflite::MicroMutableOpResolver<10> micro_op_resolver;
-    RegisterOps(micro_op_resolver, is_letter);
+    bool is_ready() const { return ready_; }
 
-    tflite::MicroInterpreter static_interpreter(model, micro_op_resolver, tensor_arena, kTensorArenaSize);
-    interpreter = &static_interpreter;
+    bool combined_active() const { return combined_active_; }
 
-    // Asignar tensores
-    if (interpreter->AllocateTensors() != kTfLiteOk)
+#if CONFIG_PLATE_RUNTIME_STATS
+    // Modelo al que se atribuyen los aciertos de caché de un tipo de posición
+    int stats_id(bool is_letter) const
     {
-        ESP_LOGE(MODEL_TAG, "Failed to allocate tensors.");
-        return;
+#if CONFIG_PLATE_COMBINED_MODEL
+        if (combined_active_)
+        {
+            return combined_.stats_id;
+        }
+#endif
+        return is_letter ? letter_.stats_id : number_.stats_id;
+    }
+#endif
+
+    size_t arena_used_bytes(bool is_letter) const
+    {
+#if CONFIG_PLATE_BACKEND_CODEGEN
+        (void)is_letter;
+        return generated_activations != nullptr ? char_models_activation_size : 0;
+#else
+#if CONFIG_PLATE_COMBINED_MODEL
+        if (combined_active_)
+        {
+            return combined_.interpreter != nullptr ? combined_.interpreter->arena_used_bytes() : 0;
+        }
+#endif
+        const ModelRuntime &runtime = is_letter ? letter_ : number_;
+        return runtime.interpreter != nullptr ? runtime.interpreter->arena_used_bytes() : 0;
+#endif
+    }
+
+    // Clasifica `count` recortes del mismo tipo. Con la cascada activa corre
+    // primero el modelo rápido y solo los caracteres con confianza menor al
+    // umbral pasan por el modelo grande; con un par cabeza/cola de salida
+    // temprana, solo esos caracteres continúan por la cola. Devuelve la
+    // cantidad de Invokes.
+    int classify_batch(bool is_letter, const CharCrop *const *crops, size_t count, char *const *results,
+                       float *const *confidences, CharTopK *const *top_k)
+    {
+        ModelRuntime &accurate = is_letter ? letter_ : number_;
+
+#if CONFIG_PLATE_EARLY_EXIT
+        ModelRuntime &head = is_letter ? letter_head_ : number_head_;
+        ModelRuntime &tail = is_letter ? letter_tail_ : number_tail_;
+        if (head.interpreter != nullptr && tail.interpreter != nullptr)
+        {
+            return run_early_exit(head, tail, crops, count, results, confidences, top_k);
+        }
+#endif
+
+#if CONFIG_PLATE_CASCADE
+        ModelRuntime &fast = is_letter ? letter_fast_ : number_fast_;
+        if (fast.interpreter != nullptr)
+        {
+            int invokes = run_batch(fast, crops, count, results, confidences, top_k);
+
+            std::vector<const CharCrop *> hard_crops;
+            std::vector<char *> hard_results;
+            std::vector<float *> hard_confidences;
+            std::vector<CharTopK *> hard_top_k;
+            for (size_t i = 0; i < count; i++)
+            {
+                if (*confidences[i] < kCascadeThreshold)
+                {
+                    hard_crops.push_back(crops[i]);
+                    hard_results.push_back(results[i]);
+                    hard_confidences.push_back(confidences[i]);
+                    hard_top_k.push_back(top_k[i]);
+                }
+            }
+            ESP_LOGI(MODEL_TAG, "Cascade %s: %d of %d chars escalated to the full model",
+                     accurate.name, (int)hard_crops.size(), (int)count);
+
+            if (!hard_crops.empty())
+            {
+                invokes += run_batch(accurate, hard_crops.data(), hard_crops.size(), hard_results.data(),
+                                     hard_confidences.data(), hard_top_k.data());
+            }
+            return invokes;
+        }
+#endif
+
+        return run_batch(accurate, crops, count, results, confidences, top_k);
+    }
+
+#if CONFIG_PLATE_COMBINED_MODEL
+    // Clasifica todos los caracteres de la patente con el modelo combinado;
+    // `is_letter[i]` elige la máscara de clases de cada recorte
+    int classify_combined(const CharCrop *const *crops, const bool *is_letter, size_t count, char *const *results,
+                          float *const *confidences, CharTopK *const *top_k)
+    {
+        return run_batch(combined_, crops, count, results, confidences, top_k, is_letter);
+    }
+#endif
+
+#if CONFIG_PLATE_OP_PROFILE
+    void log_profiles(bool csv)
+    {
+        const ModelRuntime *runtimes[] = {
+            &letter_, &number_,
+#if CONFIG_PLATE_CASCADE
+            &letter_fast_, &number_fast_,
+#endif
+#if CONFIG_PLATE_EARLY_EXIT
+            &letter_head_, &letter_tail_, &number_head_, &number_tail_,
+#endif
+#if CONFIG_PLATE_COMBINED_MODEL
+            &combined_,
+#endif
+        };
+        bool header = true;
+        for (const ModelRuntime *runtime : runtimes)
+        {
+            if (runtime->profiler == nullptr)
+            {
+                continue;
+            }
+            if (csv)
+            {
+                runtime->profiler->LogCsv(header);
+                header = false;
+            }
+            else
+            {
+                runtime->profiler->LogTable();
+            }
+        }
+    }
+
+    void reset_profiles()
+    {
+        ModelRuntime *runtimes[] = {
+            &letter_, &number_,
+#if CONFIG_PLATE_CASCADE
+            &letter_fast_, &number_fast_,
+#endif
+#if CONFIG_PLATE_EARLY_EXIT
+            &letter_head_, &letter_tail_, &number_head_, &number_tail_,
+#endif
+#if CONFIG_PLATE_COMBINED_MODEL
+            &combined_,
+#endif
+        };
+        for (ModelRuntime *runtime : runtimes)
+        {
+            if (runtime->profiler != nullptr)
+            {
+                runtime->profiler->Reset();
+            }
+        }
+    }
+#endif
+
+private:
+    // Clasifica `count` recortes con un modelo. Si el modelo se exportó con
+    // dimensión de batch N, se rellenan N entradas por Invoke; con batch 1 se hace
+    // un Invoke por recorte sobre el intérprete ya construido. Las entradas no
+    // nulas de `top_k` reciben las mejores clases de su recorte. `slot_is_letter`
+    // solo hace falta con el modelo combinado.
+    int run_batch(ModelRuntime &runtime, const CharCrop *const *crops, size_t count, char *const *results,
+                  float *const *confidences, CharTopK *const *top_k, const bool *slot_is_letter = nullptr)
+    {
+        int zero_shift = -128;
+#if !CONFIG_PLATE_BACKEND_CODEGEN
+        zero_shift = (runtime.input->type == kTfLiteInt8) ? -128 : 0;
+#endif
+        int invokes = 0;
+        size_t batch = runtime.batch_size;
+#if CONFIG_PLATE_EARLY_EXIT
+        // Los rasgos de una cabeza de salida temprana se guardan fuera de la arena:
+        // el siguiente Invoke (o la cola, con la arena compartida) los pisa
+        size_t feature_size = runtime.features != nullptr ? runtime.features->bytes / batch : 0;
+        exit_features_.resize(count * feature_size);
+#endif
+
+#if CONFIG_PLATE_INPUT_STAGING
+        // Con más de un Invoke, cada bloque se prepara en el otro núcleo mientras
+        // corre el anterior. `pending` indica que el bloque actual ya se encoló.
+        // Si este Invoke corre en el núcleo de la tarea de staging no hay nada que
+        // solapar (la tarea, de mayor prioridad, solo lo interrumpiría) y se
+        // prepara en línea.
+        bool pending = false;
+        int staging = 0;
+        if (count > batch && batch <= staging_images_ && xPortGetCoreID() != CONFIG_PLATE_INPUT_STAGING_CORE)
+        {
+            pending = input_stager_begin(crops, batch, staging_[staging], IMAGE_WIDTH, IMAGE_HEIGHT, zero_shift);
+        }
+#endif
+
+        for (size_t first = 0; first < count; first += batch)
+        {
+            size_t chunk = std::min(count - first, batch);
+            bool prepared = true;
+
+#if CONFIG_PLATE_INPUT_STAGING
+            if (pending)
+            {
+                prepared = input_stager_wait();
+                const int8_t *ready = staging_[staging];
+                staging ^= 1;
+                size_t next = first + chunk;
+                pending = next < count && input_stager_begin(crops + next, std::min(count - next, batch),
+                                                             staging_[staging], IMAGE_WIDTH, IMAGE_HEIGHT,
+                                                             zero_shift);
+                memcpy(runtime.input_data, ready, chunk * kImageSize);
+            }
+            else
+#endif
+            {
+                // Recortar, redimensionar y cuantizar cada carácter directamente en
+                // su posición del tensor de entrada
+                for (size_t k = 0; k < chunk; k++)
+                {
+                    prepared &= crop_resize_quantize(*crops[first + k], runtime.input_data + k * kImageSize,
+                                                     IMAGE_WIDTH, IMAGE_HEIGHT, zero_shift);
+                }
+            }
+
+            // Ejecutar la inferencia. Un bloque sin entrada preparada se marca
+            // como fallido igual que un Invoke que falla.
+            int64_t start_time = esp_timer_get_time();
+            bool ok = prepared && invoke(runtime);
+            if (!ok)
+            {
+                if (!prepared)
+                {
+                    ESP_LOGE(MODEL_TAG, "Failed to prepare the %s model input.", runtime.name);
+                }
+                else
+                {
+                    ESP_LOGE(MODEL_TAG, "Invoke failed on %s model.", runtime.name);
+                }
+                for (size_t k = 0; k < chunk; k++)
+                {
+                    *results[first + k] = '\0';
+                    *confidences[first + k] = 0.0f;
+                    if (top_k[first + k] != nullptr)
+                    {
+                        *top_k[first + k] = CharTopK{};
+                    }
+                }
+                continue;
+            }
+            int64_t end_time = esp_timer_get_time();
+            invokes++;
+#if CONFIG_PLATE_RUNTIME_STATS
+            model_stats_record_invoke(runtime.stats_id, (uint32_t)(end_time - start_time), (int)chunk);
+#endif
+            LOG_INVOKE_TIME(MODEL_TAG, "Inference time (%s, %d chars): %.6f s (setup already paid at boot: %.6f s)",
+                            runtime.name, (int)chunk, (end_time - start_time) / 1000000.0,
+                            runtime.setup_time_us / 1000000.0);
+
+            for (size_t k = 0; k < chunk; k++)
+            {
+                bool is_letter = slot_is_letter != nullptr ? slot_is_letter[first + k] : runtime.is_letter;
+                *confidences[first + k] = printPredictedClass(runtime, k, is_letter, results[first + k]);
+                if (top_k[first + k] != nullptr)
+                {
+                    collect_top_k(runtime, k, is_letter, top_k[first + k]);
+                }
+#if CONFIG_PLATE_EARLY_EXIT
+                if (feature_size > 0)
+                {
+                    memcpy(exit_features_.data() + (first + k) * feature_size,
+                           runtime.features->data.int8 + k * feature_size, feature_size);
+                }
+#endif
+            }
+        }
+        return invokes;
+    }
+
+#if CONFIG_PLATE_EARLY_EXIT
+    // Corre la cabeza sobre todos los recortes y la cola solo sobre los que la
+    // cabeza no resolvió con confianza suficiente. La cola toma los rasgos que
+    // dejó la cabeza, así que el primer bloque nunca se calcula dos veces.
+    int run_early_exit(ModelRuntime &head, ModelRuntime &tail, const CharCrop *const *crops, size_t count,
+                       char *const *results, float *const *confidences, CharTopK *const *top_k)
+    {
+        int invokes = run_batch(head, crops, count, results, confidences, top_k);
+
+        // Un Invoke fallido deja '\0' y no tiene rasgos válidos
+        std::vector<size_t> hard;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (*results[i] != '\0' && *confidences[i] < kEarlyExitThreshold)
+            {
+                hard.push_back(i);
+            }
+        }
+        ESP_LOGI(MODEL_TAG, "Early exit %s: %d of %d chars finished at the exit head", head.name,
+                 (int)(count - hard.size()), (int)count);
+
+        size_t feature_size = head.features->bytes / head.batch_size;
+        size_t batch = tail.batch_size;
+        for (size_t first = 0; first < hard.size(); first += batch)
+        {
+            size_t chunk = std::min(hard.size() - first, batch);
+            for (size_t k = 0; k < chunk; k++)
+            {
+                memcpy(tail.input_data + k * feature_size, exit_features_.data() + hard[first + k] * feature_size,
+                       feature_size);
+            }
+
+            // Si la cola falla queda la respuesta de la cabeza
+            int64_t start_time = esp_timer_get_time();
+            if (!invoke(tail))
+            {
+                ESP_LOGE(MODEL_TAG, "Invoke failed on %s model.", tail.name);
+                continue;
+            }
+            int64_t end_time = esp_timer_get_time();
+            invokes++;
+#if CONFIG_PLATE_RUNTIME_STATS
+            model_stats_record_invoke(tail.stats_id, (uint32_t)(end_time - start_time), (int)chunk);
+#endif
+            LOG_INVOKE_TIME(MODEL_TAG, "Inference time (%s, %d chars): %.6f s", tail.name, (int)chunk,
+                            (end_time - start_time) / 1000000.0);
+
+            for (size_t k = 0; k < chunk; k++)
+            {
+                size_t i = hard[first + k];
+                *confidences[i] = printPredictedClass(tail, k, tail.is_letter, results[i]);
+                if (top_k[i] != nullptr)
+                {
+                    collect_top_k(tail, k, tail.is_letter, top_k[i]);
+                }
+            }
+        }
+        return invokes;
+    }
+#endif
+
+    static bool invoke(ModelRuntime &runtime)
+    {
+#if CONFIG_PLATE_BACKEND_CODEGEN
+        runtime.generated_invoke(runtime.input_data, generated_output, generated_activations, generated_scratch);
+        return true;
+#else
+#if CONFIG_PLATE_OP_PROFILE
+        if (runtime.profiler != nullptr)
+        {
+            runtime.profiler->BeginInvoke();
+        }
+#endif
+        return runtime.interpreter->Invoke() == kTfLiteOk;
+#endif
+    }
+
+    // Busca el modelo por nombre en la partición de modelos o entre los arrays
+    // compilados, según CONFIG_PLATE_MODEL_SOURCE
+    static bool find_model(const char *name, bool is_letter, bool is_combined, bool feature_input, ModelBlob *blob)
+    {
+#if CONFIG_PLATE_MODEL_SOURCE_PARTITION
+        if (!model_partition_find(name, blob))
+        {
+            return false;
+        }
+        // El preprocesado y la lectura de la salida asumen entrada 20x32x1 y 26/11
+        // clases; el modelo combinado trae las suyas en el mapa de clases. La
+        // entrada de una cola de salida temprana se valida contra su cabeza.
+        int expected_classes = is_combined ? blob->num_classes : (is_letter ? 26 : 11);
+        bool image_input = blob->input_width == IMAGE_WIDTH && blob->input_height == IMAGE_HEIGHT &&
+                           blob->input_channels == 1;
+        if (!(image_input || feature_input) || blob->num_classes != expected_classes)
+        {
+            ESP_LOGE(MODEL_TAG, "Model %s has input %dx%dx%d and %d classes, expected %dx%dx1 and %d", name,
+                     blob->input_width, blob->input_height, blob->input_channels, blob->num_classes, IMAGE_WIDTH,
+                     IMAGE_HEIGHT, expected_classes);
+            return false;
+        }
+        return true;
+#else
+        // Los arrays compilados no traen forma ni clases que validar
+        (void)is_combined;
+        (void)feature_input;
+        const unsigned char *data = nullptr;
+        size_t size = 0;
+        if (strcmp(name, "letter") == 0)
+        {
+            data = model_tflite;
+            size = model_tflite_len;
+        }
+        else if (strcmp(name, "number") == 0)
+        {
+            data = number_model_tflite;
+            size = number_model_tflite_len;
+        }
+        else if (strcmp(name, "letter-fast") == 0 && letter_fast_model_tflite != nullptr)
+        {
+            data = letter_fast_model_tflite;
+            size = letter_fast_model_tflite_len;
+        }
+        else if (strcmp(name, "number-fast") == 0 && number_fast_model_tflite != nullptr)
+        {
+            data = number_fast_model_tflite;
+            size = number_fast_model_tflite_len;
+        }
+#if CONFIG_PLATE_EARLY_EXIT
+        else if (strcmp(name, "letter-head") == 0 && letter_head_model_tflite != nullptr)
+        {
+            data = letter_head_model_tflite;
+            size = letter_head_model_tflite_len;
+        }
+        else if (strcmp(name, "letter-tail") == 0 && letter_tail_model_tflite != nullptr)
+        {
+            data = letter_tail_model_tflite;
+            size = letter_tail_model_tflite_len;
+        }
+        else if (strcmp(name, "number-head") == 0 && number_head_model_tflite != nullptr)
+        {
+            data = number_head_model_tflite;
+            size = number_head_model_tflite_len;
+        }
+        else if (strcmp(name, "number-tail") == 0 && number_tail_model_tflite != nullptr)
+        {
+            data = number_tail_model_tflite;
+            size = number_tail_model_tflite_len;
+        }
+#endif
+#if CONFIG_PLATE_COMBINED_MODEL
+        else if (strcmp(name, "plate") == 0 && plate_model_tflite != nullptr)
+        {
+            *blob = {plate_model_tflite, plate_model_tflite_len, 0, IMAGE_WIDTH, IMAGE_HEIGHT, 1,
+                     (int)strlen(kCombinedClassMap), kCombinedClassMap};
+            return true;
+        }
+#endif
+        if (data == nullptr)
+        {
+            return false;
+        }
+        *blob = {data, size, 0, IMAGE_WIDTH, IMAGE_HEIGHT, 1, is_letter ? 26 : 11, nullptr};
+        return true;
+#endif
+    }
+
+    static void describe_model(ModelRuntime &runtime, const char *name, bool is_letter, size_t tensor_arena_size,
+                               bool is_combined = false, bool feature_input = false)
+    {
+        ModelBlob blob = {};
+        bool found = find_model(name, is_letter, is_combined, feature_input, &blob);
+
+        runtime.name = name;
+        runtime.is_letter = is_letter;
+        runtime.model_data = found ? blob.data : nullptr;
+        runtime.model_size = found ? blob.size : 0;
+        runtime.model_version = found ? blob.version : 0;
+        runtime.class_map = found ? blob.class_map : nullptr;
+        runtime.num_classes = found ? blob.num_classes : 0;
+        runtime.is_combined = is_combined;
+        runtime.feature_input = feature_input;
+        runtime.weights = nullptr;
+        runtime.tensor_arena = nullptr;
+        runtime.tensor_arena_size = tensor_arena_size;
+        runtime.model = nullptr;
+        runtime.allocator = nullptr;
+        runtime.interpreter = nullptr;
+#if CONFIG_PLATE_OP_PROFILE
+        runtime.profiler = nullptr;
+#endif
+#if CONFIG_PLATE_RUNTIME_STATS
+        runtime.stats_id = -1;
+#endif
+        runtime.input = nullptr;
+        runtime.output = nullptr;
+#if CONFIG_PLATE_EARLY_EXIT
+        runtime.features = nullptr;
+#endif
+        runtime.input_data = nullptr;
+        runtime.output_data = nullptr;
+        runtime.output_scale = 0.0f;
+        runtime.output_zero_point = 0;
+        runtime.output_logits = false;
+        runtime.batch_size = 1;
+        runtime.setup_time_us = 0;
+    }
+
+#if CONFIG_PLATE_BACKEND_CODEGEN
+    // Un solo bloque para activaciones, entrada y salida, más el scratch de las
+    // convoluciones de esp-nn dimensionado para el mayor de los dos modelos
+    static bool allocate_generated_buffers()
+    {
+        size_t scratch_size = std::max(letter_model_scratch_size(), number_model_scratch_size());
+        generated_activations = reinterpret_cast<int8_t *>(
+            allocate_arena(char_models_activation_size + kImageSize + kMaxClasses, kArenaPlacement));
+        generated_scratch = scratch_size > 0 ? allocate_arena(scratch_size, kArenaPlacement) : nullptr;
+        if (generated_activations == nullptr || (scratch_size > 0 && generated_scratch == nullptr))
+        {
+            ESP_LOGE(MODEL_TAG, "Failed to allocate generated model buffers in %s", placement_name(kArenaPlacement));
+            return false;
+        }
+        generated_input = generated_activations + char_models_activation_size;
+        generated_output = generated_input + kImageSize;
+        ESP_LOGI(MODEL_TAG, "Generated models: %u activation bytes, %u scratch bytes in %s",
+                 (unsigned)char_models_activation_size, (unsigned)scratch_size, placement_name(kArenaPlacement));
+        return true;
+    }
+
+    bool setup_model(ModelRuntime &runtime)
+    {
+        static_assert(letter_model_num_classes <= kMaxClasses && number_model_num_classes <= kMaxClasses,
+                      "generated output buffer too small");
+
+        runtime.generated_invoke = runtime.is_letter ? letter_model_invoke : number_model_invoke;
+        runtime.input_data = generated_input;
+        runtime.output_data = generated_output;
+        runtime.output_scale = runtime.is_letter ? letter_model_output_scale : number_model_output_scale;
+        runtime.output_zero_point = runtime.is_letter ? letter_model_output_zero_point
+                                                      : number_model_output_zero_point;
+        runtime.output_logits = runtime.is_letter ? letter_model_output_logits : number_model_output_logits;
+        runtime.batch_size = 1;
+#if CONFIG_PLATE_RUNTIME_STATS
+        runtime.stats_id = model_stats_register(runtime.name, char_models_activation_size);
+#endif
+        ESP_LOGI(MODEL_TAG, "Model %s ready (generated code, weights in flash)", runtime.name);
+        return true;
+    }
+#else
+    bool setup_model(ModelRuntime &runtime)
+    {
+        int64_t start_time = esp_timer_get_time();
+
+        // Ubicar pesos y arena según la política configurada
+        runtime.weights = place_model_weights(runtime.model_data, runtime.model_size, kWeightsPlacement);
+        if (runtime.weights == nullptr)
+        {
+            ESP_LOGW(MODEL_TAG, "No room for %s weights in %s, reading them from flash",
+                     runtime.name, placement_name(kWeightsPlacement));
+            runtime.weights = runtime.model_data;
+        }
+        runtime.tensor_arena = allocate_arena(runtime.tensor_arena_size, kArenaPlacement);
+        if (runtime.tensor_arena == nullptr)
+        {
+            ESP_LOGE(MODEL_TAG, "Failed to allocate %s arena in %s", runtime.name, placement_name(kArenaPlacement));
+            return false;
+        }
+
+        // Cargar el modelo
+        runtime.model = tflite::GetModel(runtime.weights);
+        if (runtime.model->version() != TFLITE_SCHEMA_VERSION)
+        {
+            ESP_LOGE(MODEL_TAG, "Model schema version mismatch (%s)", runtime.name);
+            return false;
+        }
+
+        // Configurar el intérprete y registrar operaciones
+        if (RegisterOps(runtime.op_resolver, runtime.model) != kTfLiteOk)
+        {
+            ESP_LOGE(MODEL_TAG, "Failed to register ops (%s)", runtime.name);
+            return false;
+        }
+
+#if CONFIG_PLATE_ARENA_LAYOUT_SHARED
+        runtime.allocator = tflite::MicroAllocator::Create(runtime.tensor_arena, runtime.tensor_arena_size,
+                                                           shared_tensor_arena, kSharedArenaSize);
+#else
+        runtime.allocator = tflite::MicroAllocator::Create(runtime.tensor_arena, runtime.tensor_arena_size);
+#endif
+        if (runtime.allocator == nullptr)
+        {
+            ESP_LOGE(MODEL_TAG, "Failed to create allocator (%s)", runtime.name);
+            return false;
+        }
+
+#if CONFIG_PLATE_OP_PROFILE
+        // El intérprete abre un evento por op; el perfil acumula los ticks por capa
+        runtime.profiler = new (std::nothrow) OpProfiler(runtime.name);
+        runtime.interpreter = new (std::nothrow) tflite::MicroInterpreter(runtime.model, runtime.op_resolver,
+                                                                          runtime.allocator, nullptr, runtime.profiler);
+#else
+        runtime.interpreter = new (std::nothrow) tflite::MicroInterpreter(runtime.model, runtime.op_resolver,
+                                                                          runtime.allocator);
+#endif
+        if (runtime.interpreter == nullptr)
+        {
+            ESP_LOGE(MODEL_TAG, "Failed to create interpreter (%s)", runtime.name);
+            return false;
+        }
+
+        // Asignar tensores
+        if (runtime.interpreter->AllocateTensors() != kTfLiteOk)
+        {
+            ESP_LOGE(MODEL_TAG, "Failed to allocate tensors (%s). Enable PLATE_ARENA_MEASURE to size the arena.",
+                     runtime.name);
+            return false;
+        }
+
+        // Obtener tensores de entrada y salida
+        runtime.input = runtime.interpreter->input(0);
+        runtime.output = runtime.interpreter->output(0);
+
+        // Comprobar que el modelo cargado coincide con lo que espera el motor (la
+        // entrada de una cola se compara con su cabeza en setup_early_exit)
+        const TfLiteIntArray *input_dims = runtime.input->dims;
+        const TfLiteIntArray *output_dims = runtime.output->dims;
+        int num_classes = runtime.num_classes;
+        bool image_input = input_dims->size == 4 && input_dims->data[1] == IMAGE_HEIGHT &&
+                           input_dims->data[2] == IMAGE_WIDTH && input_dims->data[3] == 1;
+        if (!(image_input || runtime.feature_input) || output_dims->data[output_dims->size - 1] != num_classes)
+        {
+            ESP_LOGE(MODEL_TAG, "Model %s tensors do not match a %dx%dx1 input and %d classes", runtime.name,
+                     IMAGE_WIDTH, IMAGE_HEIGHT, num_classes);
+            return false;
+        }
+        runtime.input_data = runtime.input->data.int8;
+        runtime.output_data = runtime.output->data.int8;
+        runtime.output_scale = runtime.output->params.scale;
+        runtime.output_zero_point = runtime.output->params.zero_point;
+        runtime.output_logits = model_outputs_logits(runtime.model);
+        runtime.batch_size = runtime.input->dims->data[0] > 0 ? runtime.input->dims->data[0] : 1;
+#if CONFIG_PLATE_EARLY_EXIT
+        // Una cabeza de salida temprana exporta las clases de salida y, como
+        // segunda salida, los rasgos que continúa la cola
+        runtime.features = runtime.interpreter->outputs_size() > 1 ? runtime.interpreter->output(1) : nullptr;
+#endif
+
+        int64_t end_time = esp_timer_get_time();
+        runtime.setup_time_us = end_time - start_time;
+#if CONFIG_PLATE_RUNTIME_STATS
+        runtime.stats_id = model_stats_register(runtime.name, runtime.interpreter->arena_used_bytes());
+#endif
+        ESP_LOGI(MODEL_TAG, "Model %s v%u ready (batch %d), setup time: %.6f s (previously paid per character)",
+                 runtime.name, (unsigned)runtime.model_version, runtime.batch_size, runtime.setup_time_us / 1000000.0);
+        ESP_LOGI(MODEL_TAG, "Model %s arena used: %u bytes (weights in %s, arena in %s)", runtime.name,
+                 (unsigned)runtime.interpreter->arena_used_bytes(),
+                 placement_name(runtime.weights == runtime.model_data ? MemoryPlacement::Flash : kWeightsPlacement),
+                 placement_name(kArenaPlacement));
+        return true;
+    }
+
+    // Deshace setup_model aunque haya fallado a mitad de camino: un modelo
+    // opcional que queda desactivado no retiene su arena, la copia de sus pesos
+    // ni su slot de estadísticas
+    void teardown_model(ModelRuntime &runtime)
+    {
+        delete runtime.interpreter;
+        runtime.interpreter = nullptr;
+#if CONFIG_PLATE_OP_PROFILE
+        delete runtime.profiler;
+        runtime.profiler = nullptr;
+#endif
+#if CONFIG_PLATE_RUNTIME_STATS
+        model_stats_unregister(runtime.stats_id);
+        runtime.stats_id = -1;
+#endif
+        // El allocator vive dentro de la arena
+        runtime.allocator = nullptr;
+        heap_caps_free(runtime.tensor_arena);
+        runtime.tensor_arena = nullptr;
+        release_model_weights(runtime.weights, runtime.model_data);
+        runtime.weights = nullptr;
+        runtime.model = nullptr;
+        runtime.input = nullptr;
+        runtime.output = nullptr;
+#if CONFIG_PLATE_EARLY_EXIT
+        runtime.features = nullptr;
+#endif
+        runtime.input_data = nullptr;
+        runtime.output_data = nullptr;
+    }
+#endif
+
+#if CONFIG_PLATE_PLACEMENT_BENCHMARK
+    // Mide el tiempo por Invoke del modelo para cada combinación de ubicación de
+    // pesos (flash/psram/dram) y arena (psram/dram), con una entrada constante.
+    static void benchmark_placements(const ModelRuntime &runtime)
+    {
+        if (runtime.model_data == nullptr)
+        {
+            return;
+        }
+
+        static const MemoryPlacement kWeightOptions[] = {MemoryPlacement::Flash, MemoryPlacement::Psram,
+                                                         MemoryPlacement::Internal};
+        static const MemoryPlacement kArenaOptions[] = {MemoryPlacement::Psram, MemoryPlacement::Internal};
+        const size_t arena_size = runtime.tensor_arena_size + kSharedArenaSize;
+
+        for (MemoryPlacement weights_placement : kWeightOptions)
+        {
+            const unsigned char *weights = place_model_weights(runtime.model_data, runtime.model_size, weights_placement);
+            if (weights == nullptr)
+            {
+                ESP_LOGW(MODEL_TAG, "Placement bench %s: no room for weights in %s", runtime.name,
+                         placement_name(weights_placement));
+                continue;
+            }
+
+            for (MemoryPlacement arena_placement : kArenaOptions)
+            {
+                uint8_t *arena = allocate_arena(arena_size, arena_placement);
+                if (arena == nullptr)
+                {
+                    ESP_LOGW(MODEL_TAG, "Placement bench %s: no room for arena in %s", runtime.name,
+                             placement_name(arena_placement));
+                    continue;
+                }
+
+                {
+                    const tflite::Model *model = tflite::GetModel(weights);
+                    tflite::MicroMutableOpResolver<10> op_resolver;
+                    RegisterOps(op_resolver, model);
+                    tflite::MicroInterpreter interpreter(model, op_resolver, arena, arena_size);
+                    if (interpreter.AllocateTensors() == kTfLiteOk)
+                    {
+                        TfLiteTensor *input = interpreter.input(0);
+                        memset(input->data.int8, 0, input->bytes);
+                        interpreter.Invoke();
+
+                        int64_t start_time = esp_timer_get_time();
+                        for (int i = 0; i < CONFIG_PLATE_PLACEMENT_BENCHMARK_RUNS; i++)
+                        {
+                            interpreter.Invoke();
+                        }
+                        int64_t end_time = esp_timer_get_time();
+                        ESP_LOGI(MODEL_TAG, "Placement bench %s: weights=%s arena=%s -> %.6f s per Invoke",
+                                 runtime.name, placement_name(weights_placement), placement_name(arena_placement),
+                                 (end_time - start_time) / 1000000.0 / CONFIG_PLATE_PLACEMENT_BENCHMARK_RUNS);
+                    }
+                    else
+                    {
+                        ESP_LOGE(MODEL_TAG, "Placement bench %s: failed to allocate tensors", runtime.name);
+                    }
+                }
+
+                heap_caps_free(arena);
+            }
+
+            release_model_weights(weights, runtime.model_data);
+        }
+    }
+#endif
+
+#if CONFIG_PLATE_ARENA_MEASURE
+    // Construye el modelo sobre una arena temporal grande con el allocator de
+    // registro para separar la parte persistente de la de activaciones, y deja
+    // en el log los valores a copiar en menuconfig.
+    static void measure_arena(ModelRuntime &runtime)
+    {
+        if (runtime.model_data == nullptr)
+        {
+            return;
+        }
+
+        uint8_t *arena = static_cast<uint8_t *>(heap_caps_aligned_alloc(16, kMeasureArenaSize, MALLOC_CAP_8BIT));
+        if (arena == nullptr)
+        {
+            ESP_LOGE(MODEL_TAG, "Arena measure: no memory for %s", runtime.name);
+            return;
+        }
+
+        {
+            const tflite::Model *model = tflite::GetModel(runtime.model_data);
+            tflite::MicroMutableOpResolver<10> op_resolver;
+            RegisterOps(op_resolver, model);
+
+            tflite::RecordingMicroAllocator *allocator = tflite::RecordingMicroAllocator::Create(arena, kMeasureArenaSize);
+            tflite::MicroInterpreter interpreter(model, op_resolver, allocator);
+            if (interpreter.AllocateTensors() == kTfLiteOk)
+            {
+                size_t persistent = allocator->GetSimpleMemoryAllocator()->GetPersistentUsedBytes();
+                size_t non_persistent = allocator->GetSimpleMemoryAllocator()->GetNonPersistentUsedBytes();
+                ESP_LOGI(MODEL_TAG, "Arena measure %s: total %u, persistent %u, activations %u bytes",
+                         runtime.name, (unsigned)interpreter.arena_used_bytes(), (unsigned)persistent,
+                         (unsigned)non_persistent);
+                allocator->PrintAllocations();
+            }
+            else
+            {
+                ESP_LOGE(MODEL_TAG, "Arena measure: failed to allocate tensors (%s)", runtime.name);
+            }
+        }
+
+        heap_caps_free(arena);
     }
+#endif
 
-    // Obtener tensores de entrada y salida
-    input = interpreter->input(0);
-    output = interpreter->output(0);
-    bool is_int8 = (input->type == kTfLiteInt8);
+#if CONFIG_PLATE_INPUT_STAGING
+    // Dos buffers del tamaño del mayor batch: uno lo copia el Invoke en curso y
+    // el otro lo llena la tarea de staging. Sin ellos se prepara en línea.
+    void setup_staging()
+    {
+        const ModelRuntime *runtimes[] = {
+            &letter_, &number_,
+#if CONFIG_PLATE_CASCADE
+            &letter_fast_, &number_fast_,
+#endif
+#if CONFIG_PLATE_EARLY_EXIT
+            &letter_head_, &number_head_,
+#endif
+#if CONFIG_PLATE_COMBINED_MODEL
+            &combined_,
+#endif
+        };
+        size_t images = 1;
+        for (const ModelRuntime *runtime : runtimes)
+        {
+            images = std::max(images, (size_t)runtime->batch_size);
+        }
 
-    // Preprocesar la imagen
-    int8_t image_data[IMAGE_WIDTH * IMAGE_HEIGHT];
-    preprocess_image(input_buffer, image_data, IMAGE_WIDTH, IMAGE_HEIGHT, is_int8);
+        if (!input_stager_start())
+        {
+            ESP_LOGW(MODEL_TAG, "Input staging disabled");
+            return;
+        }
+        for (int8_t *&buffer : staging_)
+        {
+            buffer = static_cast<int8_t *>(
+                heap_caps_aligned_alloc(16, images * kImageSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+        }
+        if (staging_[0] == nullptr || staging_[1] == nullptr)
+        {
+            ESP_LOGW(MODEL_TAG, "No memory for input staging buffers, staging disabled");
+            heap_caps_free(staging_[0]);
+            heap_caps_free(staging_[1]);
+            staging_[0] = staging_[1] = nullptr;
+            return;
+        }
+        staging_images_ = images;
+        ESP_LOGI(MODEL_TAG, "Input staging: 2 x %u bytes", (unsigned)(images * kImageSize));
+    }
+#endif
 
-    // Copiar datos preprocesados al tensor de entrada
-    memcpy(input->data.int8, image_data, sizeof(image_data));
+#if CONFIG_PLATE_CASCADE
+    void setup_fast_model(ModelRuntime &runtime)
+    {
+        if (runtime.model_data == nullptr)
+        {
+            ESP_LOGW(MODEL_TAG, "No %s model linked, cascade disabled for it", runtime.name);
+            return;
+        }
+        if (!setup_model(runtime))
+        {
+            ESP_LOGW(MODEL_TAG, "Cascade disabled for %s", runtime.name);
+            teardown_model(runtime);
+        }
+    }
+#endif
 
-    // Ejecutar la inferencia
-    start_time = esp_timer_get_time();
-    interpreter->Invoke();
-    end_time = esp_timer_get_time();
-    ESP_LOGI(MODEL_TAG, "Inference time: %.6f s", (end_time - start_time)/ 1000000.0);
+#if CONFIG_PLATE_EARLY_EXIT
+    // Los rasgos de la cabeza se copian tal cual a la entrada de la cola, así que
+    // ambas etapas tienen que coincidir en tamaño y cuantización
+    void setup_early_exit(ModelRuntime &head, ModelRuntime &tail)
+    {
+        if (head.model_data == nullptr || tail.model_data == nullptr)
+        {
+            ESP_LOGW(MODEL_TAG, "No %s/%s models linked, early exit disabled for them", head.name, tail.name);
+            return;
+        }
+        if (!setup_model(head) || !setup_model(tail))
+        {
+            ESP_LOGW(MODEL_TAG, "Early exit disabled for %s", head.name);
+            teardown_model(head);
+            teardown_model(tail);
+            return;
+        }
 
-    // Manejar la salida del modelo
-    printPredictedClass(is_letter, result);
+        const TfLiteTensor *features = head.features;
+        size_t feature_size = features != nullptr ? features->bytes / head.batch_size : 0;
+        if (features == nullptr || features->type != kTfLiteInt8 || tail.input->type != kTfLiteInt8 ||
+            tail.input->bytes / tail.batch_size != feature_size ||
+            features->params.scale != tail.input->params.scale ||
+            features->params.zero_point != tail.input->params.zero_point)
+        {
+            ESP_LOGE(MODEL_TAG, "Model %s features do not match the %s input, early exit disabled", head.name,
+                     tail.name);
+            teardown_model(head);
+            teardown_model(tail);
+            return;
+        }
+        ESP_LOGI(MODEL_TAG, "Early exit %s: %u feature bytes per char, exit threshold %.2f", head.name,
+                 (unsigned)feature_size, kEarlyExitThreshold);
+    }
+#endif
+
+    bool ready_ = false;
+    bool combined_active_ = false;
+    ModelRuntime letter_;
+    ModelRuntime number_;
+#if CONFIG_PLATE_CASCADE
+    ModelRuntime letter_fast_;
+    ModelRuntime number_fast_;
+#endif
+#if CONFIG_PLATE_EARLY_EXIT
+    ModelRuntime letter_head_;
+    ModelRuntime letter_tail_;
+    ModelRuntime number_head_;
+    ModelRuntime number_tail_;
+    std::vector<int8_t> exit_features_;
+#endif
+#if CONFIG_PLATE_COMBINED_MODEL
+    ModelRuntime combined_;
+#endif
+#if CONFIG_PLATE_INPUT_STAGING
+    int8_t *staging_[2] = {nullptr, nullptr};
+    size_t staging_images_ = 0;
+#endif
+};
+
+static InferenceEngine engine;
+
+bool init_models()
+{
+    return engine.init();
+}
+
+size_t model_arena_used_bytes(bool is_letter)
+{
+    return engine.arena_used_bytes(is_letter);
 }
 
 void run_model(bool is_letter, uint8_t* input_buffer, char* result)
 {
-    const unsigned char* model_to_use = is_letter ? model_tflite : number_model_tflite;
-    run_inference(is_letter, model_to_use, input_buffer, result);
+    // Un recorte ya redimensionado a 20x32 se copia tal cual (escala 1)
+    CharCrop crop = {input_buffer, IMAGE_WIDTH, 0, 0, IMAGE_WIDTH, IMAGE_HEIGHT};
+    run_model_batch(&crop, &is_letter, 1, result, nullptr);
+}
+
+void run_model_batch(const CharCrop* crops, const bool* is_letter, size_t count, char* results, float* confidences,
+                     CharTopK* top_k)
+{
+    if (!engine.is_ready() && !engine.init())
+    {
+        ESP_LOGE(MODEL_TAG, "Inference engine not initialized.");
+        memset(results, 0, count);
+        return;
+    }
+
+    std::vector<float> local_confidences;
+    if (confidences == nullptr)
+    {
+        local_confidences.resize(count);
+        confidences = local_confidences.data();
+    }
+
+#if CONFIG_PLATE_RESULT_CACHE
+    // La caché guarda las alternativas de cada recorte aunque esta llamada no
+    // las pida, para poder responder después a una que sí
+    std::vector<CharTopK> local_top_k;
+    if (top_k == nullptr)
+    {
+        local_top_k.resize(count);
+        top_k = local_top_k.data();
+    }
+
+    // Los recortes casi idénticos a uno ya clasificado se responden desde la caché
+    std::vector<CropHash> hashes(count);
+    std::unique_ptr<bool[]> cached(new bool[count]);
+    int cache_hits = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        hashes[i] = crop_hash(crops[i]);
+        cached[i] = result_cache_lookup(hashes[i], is_letter[i], &results[i], &confidences[i], &top_k[i]);
+        cache_hits += cached[i] ? 1 : 0;
+#if CONFIG_PLATE_RUNTIME_STATS
+        if (cached[i])
+        {
+            model_stats_record_cache_hits(engine.stats_id(is_letter[i]), 1);
+        }
+#endif
+    }
+#endif
+
+    // Separar los recortes por modelo conservando su posición en la patente. Con
+    // el modelo combinado van todos a la primera lista, en orden, y la máscara
+    // de clases de cada una sale de letter_slots.
+    bool combined = engine.combined_active();
+    std::vector<const CharCrop *> letter_inputs, number_inputs;
+    std::vector<char *> letter_results, number_results;
+    std::vector<float *> letter_confidences, number_confidences;
+    std::vector<CharTopK *> letter_top_k, number_top_k;
+    std::unique_ptr<bool[]> letter_slots(new bool[count]);
+    for (size_t i = 0; i < count; i++)
+    {
+#if CONFIG_PLATE_RESULT_CACHE
+        if (cached[i])
+        {
+            continue;
+        }
+#endif
+        if (is_letter[i] || combined)
+        {
+            letter_slots[letter_inputs.size()] = is_letter[i];
+            letter_inputs.push_back(&crops[i]);
+            letter_results.push_back(&results[i]);
+            letter_confidences.push_back(&confidences[i]);
+            letter_top_k.push_back(top_k != nullptr ? &top_k[i] : nullptr);
+        }
+        else
+        {
+            number_inputs.push_back(&crops[i]);
+            number_results.push_back(&results[i]);
+            number_confidences.push_back(&confidences[i]);
+            number_top_k.push_back(top_k != nullptr ? &top_k[i] : nullptr);
+        }
+    }
+
+    int invokes = 0;
+#if CONFIG_PLATE_COMBINED_MODEL
+    if (combined)
+    {
+        invokes = engine.classify_combined(letter_inputs.data(), letter_slots.get(), letter_inputs.size(),
+                                           letter_results.data(), letter_confidences.data(), letter_top_k.data());
+        letter_inputs.clear();
+    }
+#endif
+    if (!letter_inputs.empty())
+    {
+        invokes += engine.classify_batch(true, letter_inputs.data(), letter_inputs.size(), letter_results.data(),
+                                         letter_confidences.data(), letter_top_k.data());
+    }
+    if (!number_inputs.empty())
+    {
+        invokes += engine.classify_batch(false, number_inputs.data(), number_inputs.size(), number_results.data(),
+                                         number_confidences.data(), number_top_k.data());
+    }
+#if CONFIG_PLATE_RESULT_CACHE
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!cached[i])
+        {
+            result_cache_insert(hashes[i], is_letter[i], results[i], confidences[i], top_k[i]);
+        }
+    }
+    ResultCacheStats cache_stats = result_cache_stats();
+    uint32_t lookups = cache_stats.hits + cache_stats.misses;
+    ESP_LOGI(MODEL_TAG, "Classified %d chars with %d Invoke calls (%d from cache, hit rate %.1f%% over %u lookups)",
+             (int)count, invokes, cache_hits, lookups > 0 ? 100.0f * cache_stats.hits / lookups : 0.0f,
+             (unsigned)lookups);
+#else
+    ESP_LOGI(MODEL_TAG, "Classified %d chars with %d Invoke calls", (int)count, invokes);
+#endif
+
+#if CONFIG_PLATE_OP_PROFILE && CONFIG_PLATE_OP_PROFILE_DUMP_INTERVAL > 0
+    static int batches_since_dump = 0;
+    if (++batches_since_dump >= CONFIG_PLATE_OP_PROFILE_DUMP_INTERVAL)
+    {
+        batches_since_dump = 0;
+#if CONFIG_PLATE_OP_PROFILE_CSV
+        engine.log_profiles(true);
+#else
+        engine.log_profiles(false);
+#endif
+    }
+#endif
 }
 
+void model_profile_dump(bool csv)
+{
+#if CONFIG_PLATE_OP_PROFILE
+    engine.log_profiles(csv);
+#else
+    (void)csv;
+    ESP_LOGW(MODEL_TAG, "Op profiling disabled (CONFIG_PLATE_OP_PROFILE)");
+#endif
+}
+
+void model_profile_reset()
+{
+#if CONFIG_PLATE_OP_PROFILE
+    engine.reset_profiles();
+#endif
+}
@@ -0,0 +1,270 @@
+// Benchmark de host del suavizado antes de Canny (Paso 4): compara el filtro
+// bilateral con la transformada de dominio en tiempo, en lectura de la patente
+// completa y en parecido de la imagen filtrada y de sus bordes. También compara
+// las versiones enteras del gaussiano del Paso 3 (gaussian_blur.h) y de Canny
+// del Paso 5 (canny.h) con las de OpenCV en tiempo y píxeles distintos (deben
+// ser cero).
+//
+// Dataset: imágenes de patentes (JPG, PNG, BMP) cuyo nombre empieza con la
+// lectura esperada, por ejemplo "AB123CD_frente.jpg" o "ABC123.png".
+//
+//   plate_filter_bench DATASET [--repeat N] [--verbose]
+//
+// El tiempo de filtrado se mide sobre la misma entrada que ve el Paso 4 en la
+// placa (gris, ancho 450, gaussiano 5x5); la lectura pasa por todo el pipeline
+// con recognize_plate.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "canny.h"
+#include "gaussian_blur.h"
+#include "pipeline_runner.h"
+#include "tf_model.h"
+
+namespace fs = std::filesystem;
+
+struct Sample {
+    std::string path;
+    std::string expected;
+    cv::Mat image;
+    cv::Mat resized;       // entrada del Paso 3
+    cv::Mat filter_input;  // entrada del Paso 4
+    cv::Mat canny_input;   // entrada del Paso 5 (con el bilateral)
+};
+
+struct FilterReport {
+    const char *name;
+    EdgeFilter filter;
+    std::vector<double> times_us;
+    int plates = 0;
+    int exact = 0;
+    int chars = 0;
+    int char_errors = 0;
+    double psnr_sum = 0.0;
+    double edge_agreement_sum = 0.0;
+};
+
+// Pasos 1 y 2 del pipeline
+static cv::Mat prepare_blur_input(const cv::Mat &image) {
+    cv::Mat gray;
+    if (image.channels() == 3) {
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        gray = image.clone();
+    }
+    cv::Mat resized;
+    int new_height = gray.rows * 450 / gray.cols;
+    cv::resize(gray, resized, cv::Size(450, new_height));
+    return resized;
+}
+
+static bool load_dataset(const char *dir, std::vector<Sample> &samples) {
+    std::error_code error;
+    std::vector<fs::path> paths;
+    for (const fs::directory_entry &entry : fs::directory_iterator(dir, error)) {
+        if (entry.is_regular_file()) {
+            paths.push_back(entry.path());
+        }
+    }
+    if (error) {
+        fprintf(stderr, "cannot read %s: %s\n", dir, error.message().c_str());
+        return false;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    for (const fs::path &path : paths) {
+        cv::Mat image = cv::imread(path.string(), cv::IMREAD_COLOR);
+        if (image.empty()) {
+            continue;
+        }
+        std::string stem = path.stem().string();
+        Sample sample;
+        sample.path = path.string();
+        sample.expected = stem.substr(0, stem.find('_'));
+        sample.image = image;
+        sample.resized = prepare_blur_input(image);
+        cv::GaussianBlur(sample.resized, sample.filter_input, cv::Size(5, 5), 0);
+        cv::bilateralFilter(sample.filter_input, sample.canny_input, 9, 36, 36);
+        samples.push_back(sample);
+    }
+    return true;
+}
+
+static int edit_distance(const std::string &a, const std::string &b) {
+    std::vector<int> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++) {
+        row[j] = (int)j;
+    }
+    for (size_t i = 1; i <= a.size(); i++) {
+        int diagonal = row[0];
+        row[0] = (int)i;
+        for (size_t j = 1; j <= b.size(); j++) {
+            int above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+// Fracción de píxeles de borde de cualquiera de los dos que coinciden, con los
+// umbrales de Canny del Paso 5
+static double edge_agreement(const cv::Mat &a, const cv::Mat &b) {
+    cv::Mat edges_a, edges_b;
+    cv::Canny(a, edges_a, 75, 200);
+    cv::Canny(b, edges_b, 75, 200);
+    int both = cv::countNonZero(edges_a & edges_b);
+    int either = cv::countNonZero(edges_a | edges_b);
+    return either == 0 ? 1.0 : (double)both / either;
+}
+
+static double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (size_t)(fraction * values.size()))];
+}
+
+// Tiempo de la versión de OpenCV y de la entera de un paso sobre `inputs`, y
+// píxeles en los que difieren
+static void compare_step(const char *name, const std::vector<const cv::Mat *> &inputs, int repeat,
+                         const std::function<void(const cv::Mat &, cv::Mat &)> &opencv,
+                         const std::function<void(const cv::Mat &, cv::Mat &)> &integer) {
+    std::vector<double> opencv_us, integer_us;
+    long mismatched = 0;
+    for (const cv::Mat *input : inputs) {
+        cv::Mat reference, output(input->size(), CV_8UC1);
+        for (int pass = 0; pass < repeat; pass++) {
+            auto t0 = std::chrono::steady_clock::now();
+            opencv(*input, reference);
+            auto t1 = std::chrono::steady_clock::now();
+            integer(*input, output);
+            auto t2 = std::chrono::steady_clock::now();
+            opencv_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+            integer_us.push_back(std::chrono::duration<double, std::micro>(t2 - t1).count());
+        }
+        mismatched += cv::countNonZero(output != reference);
+    }
+    printf("%-17s %9s %9s %11s\n", name, "p50_us", "p95_us", "mismatched");
+    printf("%-17s %9.0f %9.0f\n", "  opencv", percentile(opencv_us, 0.5), percentile(opencv_us, 0.95));
+    printf("%-17s %9.0f %9.0f %11ld\n", "  integer", percentile(integer_us, 0.5), percentile(integer_us, 0.95),
+           mismatched);
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s DATASET [--repeat N] [--verbose]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    const char *dataset = nullptr;
+    int repeat = 5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            esp_log_level_set("*", ESP_LOG_INFO);
+        } else if (argv[i][0] != '-' && dataset == nullptr) {
+            dataset = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (dataset == nullptr) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<Sample> samples;
+    if (!load_dataset(dataset, samples) || samples.empty()) {
+        fprintf(stderr, "no images found in %s\n", dataset);
+        return 2;
+    }
+    if (!init_models()) {
+        fprintf(stderr, "model initialization failed\n");
+        return 2;
+    }
+
+    // Pasos 3 y 5: versiones enteras contra OpenCV
+    std::vector<const cv::Mat *> blur_inputs, canny_inputs;
+    int max_width = 0, max_height = 0;
+    for (const Sample &sample : samples) {
+        blur_inputs.push_back(&sample.resized);
+        canny_inputs.push_back(&sample.canny_input);
+        max_width = std::max(max_width, sample.canny_input.cols);
+        max_height = std::max(max_height, sample.canny_input.rows);
+    }
+    compare_step("gaussian 5x5", blur_inputs, repeat,
+                 [](const cv::Mat &in, cv::Mat &out) { cv::GaussianBlur(in, out, cv::Size(5, 5), 0); },
+                 [](const cv::Mat &in, cv::Mat &out) {
+                     gaussian_blur_5x5(in.data, in.step, out.data, out.step, in.cols, in.rows);
+                 });
+    canny_reserve(max_width, max_height);
+    compare_step("canny 75/200", canny_inputs, repeat,
+                 [](const cv::Mat &in, cv::Mat &out) { cv::Canny(in, out, 75, 200); },
+                 [](const cv::Mat &in, cv::Mat &out) {
+                     canny_edges(in.data, in.step, out.data, out.step, in.cols, in.rows, 75, 200);
+                 });
+    printf("\n");
+
+    FilterReport reports[2];
+    reports[0].name = "bilateral";
+    reports[0].filter = EdgeFilter::Bilateral;
+    reports[1].name = "domain-transform";
+    reports[1].filter = EdgeFilter::DomainTransform;
+
+    for (const Sample &sample : samples) {
+        cv::Mat reference;
+        apply_edge_filter(sample.filter_input, reference, EdgeFilter::Bilateral);
+
+        for (FilterReport &report : reports) {
+            cv::Mat filtered;
+            for (int pass = 0; pass < repeat; pass++) {
+                auto t0 = std::chrono::steady_clock::now();
+                apply_edge_filter(sample.filter_input, filtered, report.filter);
+                auto t1 = std::chrono::steady_clock::now();
+                report.times_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+            }
+            report.psnr_sum += std::min(cv::PSNR(reference, filtered), 99.0);
+            report.edge_agreement_sum += edge_agreement(reference, filtered);
+
+            // recognize_plate modifica su entrada
+            cv::Mat image = sample.image.clone();
+            std::string reading = recognize_plate(image, report.filter);
+            int errors = edit_distance(sample.expected, reading);
+            report.plates++;
+            report.chars += (int)sample.expected.size();
+            report.char_errors += errors;
+            if (errors == 0) {
+                report.exact++;
+            } else {
+                ESP_LOGI("BENCH", "%s (%s): expected %s, got %s", sample.path.c_str(), report.name,
+                         sample.expected.c_str(), reading.c_str());
+            }
+        }
+    }
+
+    printf("%-17s %9s %9s %8s %8s %8s %8s\n", "filter", "p50_us", "p95_us", "plates", "chars", "psnr", "edges");
+    for (const FilterReport &report : reports) {
+        printf("%-17s %9.0f %9.0f %7.2f%% %7.2f%% %8.2f %7.2f%%\n", report.name, percentile(report.times_us, 0.5),
+               percentile(report.times_us, 0.95), 100.0 * report.exact / report.plates,
+               100.0 * std::max(0, report.chars - report.char_errors) / std::max(1, report.chars),
+               report.psnr_sum / report.plates, 100.0 * report.edge_agreement_sum / report.plates);
+    }
+    printf("psnr and edges are measured against the bilateral output (%zu images)\n", samples.size());
+    return 0;
+}
@@ -0,0 +1,305 @@
+// Prueba de host de las versiones enteras de los pasos del pipeline contra
+// OpenCV: cada caso genera una imagen, corre el kernel entero y la función de
+// OpenCV que reemplaza, y compara píxel a píxel. Cualquier diferencia es un
+// fallo y el programa termina con 1.
+//
+//   plate_kernel_test [--verbose]
+//
+// Cubre el gaussiano 5x5 del Paso 3 (gaussian_blur.h), incluidas las franjas
+// y las entradas con stride, y Canny del Paso 5 (canny.h) con varios umbrales,
+// en el lugar y en otro buffer, y la morfología de 1 bit por píxel de los
+// pasos 6, 8 y 9 (binary_morphology.h) con anchos a los lados de cada palabra
+// de 32 bits. plate_kernel_test_small_stack es la misma prueba con la pila de
+// la histéresis reducida a una fila (CANNY_STACK_FRACTION), así Canny termina
+// por los barridos.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include "binary_morphology.h"
+#include "canny.h"
+#include "gaussian_blur.h"
+
+enum class Pattern { Noise, Flat, Gradient, Stripes, Smooth };
+
+static const Pattern kPatterns[] = {Pattern::Noise, Pattern::Flat, Pattern::Gradient, Pattern::Stripes,
+                                    Pattern::Smooth};
+
+static const char *pattern_name(Pattern pattern) {
+    switch (pattern) {
+    case Pattern::Noise:
+        return "noise";
+    case Pattern::Flat:
+        return "flat";
+    case Pattern::Gradient:
+        return "gradient";
+    case Pattern::Stripes:
+        return "stripes";
+    case Pattern::Smooth:
+        return "smooth";
+    }
+    return "?";
+}
+
+static int cases = 0;
+static int failures = 0;
+static bool verbose = false;
+
+// xorshift32: las imágenes son las mismas en cada corrida y en cada plataforma
+static uint32_t next_random(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static cv::Mat make_image(int width, int height, Pattern pattern, uint32_t seed) {
+    cv::Mat image(height, width, CV_8UC1);
+    uint32_t state = seed * 2654435761u + 1;
+    for (int y = 0; y < height; y++) {
+        uint8_t *row = image.ptr<uint8_t>(y);
+        for (int x = 0; x < width; x++) {
+            switch (pattern) {
+            case Pattern::Noise:
+            case Pattern::Smooth:
+                row[x] = (uint8_t)(next_random(state) >> 24);
+                break;
+            case Pattern::Flat:
+                row[x] = (uint8_t)(seed * 37);
+                break;
+            case Pattern::Gradient:
+                row[x] = (uint8_t)((x * 255 / std::max(1, width - 1) + y * 3) & 0xff);
+                break;
+            case Pattern::Stripes:
+                // Bloques claros y oscuros con un poco de ruido, como trazos de caracteres
+                row[x] = (uint8_t)(((x / 7 + y / 11) % 2 ? 200 : 50) + (int)(next_random(state) >> 28) - 8);
+                break;
+            }
+        }
+    }
+    if (pattern == Pattern::Smooth) {
+        cv::GaussianBlur(image, image, cv::Size(0, 0), 3.0);
+        cv::normalize(image, image, 0, 255, cv::NORM_MINMAX);
+    }
+    return image;
+}
+
+static void expect_equal(const std::string &name, const cv::Mat &expected, const cv::Mat &actual) {
+    cases++;
+    long mismatched = 0;
+    int first_x = -1, first_y = -1;
+    for (int y = 0; y < expected.rows; y++) {
+        const uint8_t *want = expected.ptr<uint8_t>(y);
+        const uint8_t *got = actual.ptr<uint8_t>(y);
+        for (int x = 0; x < expected.cols; x++) {
+            if (want[x] != got[x]) {
+                if (mismatched++ == 0) {
+                    first_x = x;
+                    first_y = y;
+                }
+            }
+        }
+    }
+    if (mismatched > 0) {
+        failures++;
+        printf("FAIL %s: %ld pixels differ, first at (%d, %d): expected %d, got %d\n", name.c_str(), mismatched,
+               first_x, first_y, expected.at<uint8_t>(first_y, first_x), actual.at<uint8_t>(first_y, first_x));
+    } else if (verbose) {
+        printf("ok   %s\n", name.c_str());
+    }
+}
+
+static std::string case_name(const char *kernel, int width, int height, Pattern pattern, const char *detail = "") {
+    char name[128];
+    snprintf(name, sizeof(name), "%s %dx%d %s%s", kernel, width, height, pattern_name(pattern), detail);
+    return name;
+}
+
+// Paso 3: gaussian_blur_5x5 contra cv::GaussianBlur(Size(5, 5), 0)
+static void test_gaussian_blur() {
+    static const int kWidths[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 31, 450, 451, 640};
+    static const int kHeights[] = {1, 2, 3, 4, 5, 8, 37, 338};
+    uint32_t seed = 1;
+    for (int height : kHeights) {
+        for (int width : kWidths) {
+            for (Pattern pattern : kPatterns) {
+                cv::Mat image = make_image(width, height, pattern, seed++);
+                cv::Mat expected, actual(height, width, CV_8UC1);
+                cv::GaussianBlur(image, expected, cv::Size(5, 5), 0);
+                if (!gaussian_blur_5x5(image.data, image.step, actual.data, actual.step, width, height)) {
+                    failures++;
+                    printf("FAIL %s: no buffer\n", case_name("gaussian", width, height, pattern).c_str());
+                    continue;
+                }
+                expect_equal(case_name("gaussian", width, height, pattern), expected, actual);
+            }
+        }
+    }
+
+    // Franjas de la imagen completa (el borde sale de las filas vecinas) y una
+    // entrada que es una ROI de una imagen más ancha
+    cv::Mat wide = make_image(460, 338, Pattern::Noise, seed++);
+    cv::Mat image = wide(cv::Rect(5, 0, 450, 338));
+    cv::Mat expected;
+    cv::GaussianBlur(image.clone(), expected, cv::Size(5, 5), 0);
+    static const int kStrips[][2] = {{0, 32}, {1, 1}, {100, 40}, {306, 32}, {337, 1}, {0, 338}};
+    for (const int *strip : kStrips) {
+        cv::Mat actual(strip[1], image.cols, CV_8UC1);
+        gaussian_blur_5x5_rows(image.data, image.step, actual.data, actual.step, image.cols, image.rows, strip[0],
+                               strip[1]);
+        char detail[32];
+        snprintf(detail, sizeof(detail), " roi rows %d+%d", strip[0], strip[1]);
+        expect_equal(case_name("gaussian", image.cols, image.rows, Pattern::Noise, detail),
+                     expected.rowRange(strip[0], strip[0] + strip[1]), actual);
+    }
+}
+
+// Paso 5: canny_edges contra cv::Canny(low, high), en el lugar y en otro buffer
+static void test_canny() {
+    static const int kSizes[][2] = {{1, 1}, {2, 3}, {3, 2}, {5, 7}, {17, 13}, {64, 64},
+                                    {450, 338}, {451, 100}, {451, 338}};
+    // Los del pipeline, unos bajos, invertidos (cv::Canny los ordena) y cero
+    static const int kThresholds[][2] = {{75, 200}, {20, 60}, {200, 75}, {0, 0}};
+    uint32_t seed = 1000;
+    for (const int *size : kSizes) {
+        int width = size[0], height = size[1];
+        if (!canny_reserve(width, height)) {
+            failures++;
+            printf("FAIL canny %dx%d: canny_reserve\n", width, height);
+            continue;
+        }
+        for (Pattern pattern : kPatterns) {
+            cv::Mat image = make_image(width, height, pattern, seed++);
+            for (const int *thresholds : kThresholds) {
+                cv::Mat expected;
+                cv::Canny(image, expected, thresholds[0], thresholds[1]);
+
+                char detail[32];
+                snprintf(detail, sizeof(detail), " %d/%d", thresholds[0], thresholds[1]);
+                cv::Mat actual(height, width, CV_8UC1);
+                canny_edges(image.data, image.step, actual.data, actual.step, width, height, thresholds[0],
+                            thresholds[1]);
+                expect_equal(case_name("canny", width, height, pattern, detail), expected, actual);
+
+                snprintf(detail, sizeof(detail), " %d/%d in place", thresholds[0], thresholds[1]);
+                cv::Mat in_place = image.clone();
+                canny_edges(in_place.data, in_place.step, in_place.data, in_place.step, width, height,
+                            thresholds[0], thresholds[1]);
+                expect_equal(case_name("canny", width, height, pattern, detail), expected, in_place);
+            }
+        }
+    }
+
+    // Una imagen más ancha pero más baja no debe achicar el alto reservado
+    cv::Mat image = make_image(451, 338, Pattern::Noise, seed++);
+    cv::Mat expected;
+    cv::Canny(image, expected, 75, 200);
+    cv::Mat actual(image.rows, image.cols, CV_8UC1);
+    if (!canny_reserve(600, 50) ||
+        !canny_edges(image.data, image.step, actual.data, actual.step, image.cols, image.rows, 75, 200)) {
+        failures++;
+        printf("FAIL canny 451x338 after reserving 600x50\n");
+    } else {
+        expect_equal(case_name("canny", image.cols, image.rows, Pattern::Noise, " after 600x50"), expected, actual);
+    }
+}
+
+// Imagen binaria con `percent` % de píxeles encendidos. Los encendidos valen
+// cualquier cosa distinta de cero, como la salida de un paso que no es 0/255.
+static cv::Mat make_binary(int width, int height, int percent, uint32_t seed) {
+    cv::Mat image(height, width, CV_8UC1);
+    uint32_t state = seed * 2654435761u + 1;
+    for (int y = 0; y < height; y++) {
+        uint8_t *row = image.ptr<uint8_t>(y);
+        for (int x = 0; x < width; x++) {
+            uint32_t random = next_random(state);
+            row[x] = (int)(random % 100) < percent ? (uint8_t)(1 + (random >> 24) % 255) : 0;
+        }
+    }
+    return image;
+}
+
+// Pasos 6, 8 y 9: binary_dilate_3x3 / binary_dilate_3x2 / binary_erode_3x2 /
+// binary_close_3x2 contra cv::dilate / cv::erode / cv::morphologyEx con los
+// mismos kernels que el pipeline
+static void test_binary_morphology() {
+    static const int kWidths[] = {1, 2, 3, 31, 32, 33, 63, 64, 65, 95, 96, 97, 450, 451};
+    static const int kHeights[] = {1, 2, 3, 4, 37, 118};
+    static const int kDensities[] = {0, 10, 50, 90, 100};
+    const cv::Mat kernel_3x3 = cv::Mat::ones(3, 3, CV_8U);
+    const cv::Mat kernel_3x2 = cv::Mat::ones(3, 2, CV_8U);
+    BinaryImage bits;
+    uint32_t seed = 5000;
+    for (int height : kHeights) {
+        for (int width : kWidths) {
+            for (int percent : kDensities) {
+                cv::Mat image = make_binary(width, height, percent, seed++);
+                cv::Mat binary(height, width, CV_8UC1);
+                for (int y = 0; y < height; y++) {
+                    for (int x = 0; x < width; x++) {
+                        binary.at<uint8_t>(y, x) = image.at<uint8_t>(y, x) != 0 ? 255 : 0;
+                    }
+                }
+
+                char name[96];
+                if (!binary_image_reserve(bits, width, height)) {
+                    failures++;
+                    printf("FAIL binary %dx%d: binary_image_reserve\n", width, height);
+                    continue;
+                }
+                struct Operation {
+                    const char *name;
+                    void (*run)(BinaryImage &);
+                    std::function<void(const cv::Mat &, cv::Mat &)> reference;
+                };
+                const Operation operations[] = {
+                    {"pack/unpack", nullptr, [](const cv::Mat &in, cv::Mat &out) { out = in.clone(); }},
+                    {"dilate 3x3", binary_dilate_3x3,
+                     [&](const cv::Mat &in, cv::Mat &out) { cv::dilate(in, out, kernel_3x3); }},
+                    {"dilate 3x2", binary_dilate_3x2,
+                     [&](const cv::Mat &in, cv::Mat &out) { cv::dilate(in, out, kernel_3x2); }},
+                    {"erode 3x2", binary_erode_3x2,
+                     [&](const cv::Mat &in, cv::Mat &out) { cv::erode(in, out, kernel_3x2); }},
+                    {"close 3x2", binary_close_3x2,
+                     [&](const cv::Mat &in, cv::Mat &out) { cv::morphologyEx(in, out, cv::MORPH_CLOSE, kernel_3x2); }},
+                };
+                for (const Operation &operation : operations) {
+                    cv::Mat expected, actual(height, width, CV_8UC1);
+                    operation.reference(binary, expected);
+                    binary_pack(image.data, image.step, bits);
+                    if (operation.run != nullptr) {
+                        operation.run(bits);
+                    }
+                    binary_unpack(bits, actual.data, actual.step);
+                    snprintf(name, sizeof(name), "binary %s %dx%d %d%%", operation.name, width, height, percent);
+                    expect_equal(name, expected, actual);
+                }
+            }
+        }
+    }
+    binary_image_release(bits);
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else {
+            fprintf(stderr, "usage: %s [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    test_gaussian_blur();
+    test_canny();
+    test_binary_morphology();
+
+    printf("%d cases, %d failed\n", cases, failures);
+    return failures == 0 ? 0 : 1;
+}
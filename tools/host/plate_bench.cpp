@@ -0,0 +1,296 @@
+// Benchmark de host de los modelos de caracteres: corre la misma lógica de
+// main/tf_model.cpp sobre kernels de referencia de TFLM contra un dataset
+// etiquetado y reporta exactitud, matriz de confusión y latencia por Invoke.
+//
+// Dataset: un subdirectorio por clase cuyo nombre es el carácter esperado
+// (A..Z, 0..9; "colon" para ':'), con recortes PGM binarios (P5) en escala de
+// grises. Se esperan de 20x32; otros tamaños se redimensionan igual que en la placa.
+//
+//   plate_host_bench DATASET [--repeat N] [--warmup N] [--min-accuracy PCT] [--profile [csv]] [--verbose]
+//
+// Con --min-accuracy el proceso termina con código 1 si algún modelo queda por
+// debajo del umbral, para usarlo como control en la máquina de build. Con
+// --profile vuelca al final el perfil por operador de las pasadas medidas
+// (model_profile_dump), como tabla o con "csv" como filas CSV.
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "tf_model.h"
+
+namespace fs = std::filesystem;
+
+struct Sample {
+    char label;
+    bool is_letter;
+    int width;
+    int height;
+    std::vector<uint8_t> pixels;
+    std::string path;
+};
+
+struct ModelReport {
+    const char *name;
+    std::string classes;
+    std::vector<int> confusion;  // filas: clase esperada, columnas: predicha
+    int samples = 0;
+    int correct = 0;
+    int unknown = 0;             // predicciones fuera del mapa de clases
+    std::vector<double> latencies_us;
+};
+
+// Lee el siguiente token de la cabecera PGM saltando comentarios
+static bool read_pgm_token(std::istream &in, int &value) {
+    in >> std::ws;
+    while (in.peek() == '#') {
+        std::string comment;
+        std::getline(in, comment);
+        in >> std::ws;
+    }
+    return static_cast<bool>(in >> value);
+}
+
+static bool load_pgm(const fs::path &path, Sample &sample) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[2];
+    if (!in.read(magic, 2) || magic[0] != 'P' || magic[1] != '5') {
+        return false;
+    }
+    int max_value;
+    if (!read_pgm_token(in, sample.width) || !read_pgm_token(in, sample.height) ||
+        !read_pgm_token(in, max_value) || max_value > 255 || sample.width <= 0 || sample.height <= 0) {
+        return false;
+    }
+    in.get();  // único blanco entre la cabecera y los píxeles
+    sample.pixels.resize((size_t)sample.width * sample.height);
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(sample.pixels.data()), sample.pixels.size()));
+}
+
+static bool load_dataset(const fs::path &root, std::vector<Sample> &samples) {
+    std::error_code error;
+    std::vector<fs::path> class_dirs;
+    for (const auto &entry : fs::directory_iterator(root, error)) {
+        if (entry.is_directory()) {
+            class_dirs.push_back(entry.path());
+        }
+    }
+    if (error) {
+        fprintf(stderr, "cannot read %s: %s\n", root.c_str(), error.message().c_str());
+        return false;
+    }
+    std::sort(class_dirs.begin(), class_dirs.end());
+
+    for (const auto &dir : class_dirs) {
+        std::string name = dir.filename().string();
+        char label = name == "colon" ? ':' : (name.size() == 1 ? (char)toupper(name[0]) : 0);
+        if (label == 0 || !(isalnum((unsigned char)label) || label == ':')) {
+            fprintf(stderr, "skipping %s: not a class directory\n", dir.c_str());
+            continue;
+        }
+
+        std::vector<fs::path> files;
+        for (const auto &entry : fs::directory_iterator(dir)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".pgm") {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const auto &file : files) {
+            Sample sample;
+            sample.label = label;
+            sample.is_letter = isalpha((unsigned char)label) != 0;
+            sample.path = file.string();
+            if (!load_pgm(file, sample)) {
+                fprintf(stderr, "skipping %s: not a binary 8-bit PGM\n", file.c_str());
+                continue;
+            }
+            samples.push_back(std::move(sample));
+        }
+    }
+    return true;
+}
+
+static double percentile(const std::vector<double> &sorted, double pct) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    // Rango más cercano: el menor valor que cubre el pct% de las muestras
+    size_t rank = (size_t)(pct / 100.0 * sorted.size() + 0.999999);
+    return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+}
+
+static void print_report(ModelReport &report) {
+    printf("\n== %s model: %d samples ==\n", report.name, report.samples);
+    if (report.samples == 0) {
+        return;
+    }
+    printf("accuracy: %.2f%% (%d/%d)", 100.0 * report.correct / report.samples, report.correct, report.samples);
+    if (report.unknown > 0) {
+        printf(", %d predictions outside the class map", report.unknown);
+    }
+    printf("\n");
+
+    std::vector<double> &lat = report.latencies_us;
+    std::sort(lat.begin(), lat.end());
+    double total = 0.0;
+    for (double value : lat) {
+        total += value;
+    }
+    printf("latency per Invoke (%zu runs): mean %.6f s, p50 %.6f s, p90 %.6f s, p99 %.6f s, max %.6f s\n",
+           lat.size(), total / lat.size() / 1e6, percentile(lat, 50) / 1e6, percentile(lat, 90) / 1e6,
+           percentile(lat, 99) / 1e6, lat.back() / 1e6);
+
+    size_t n = report.classes.size();
+    printf("confusion matrix (rows: expected, columns: predicted)\n     ");
+    for (size_t col = 0; col < n; col++) {
+        printf("%4c", report.classes[col]);
+    }
+    printf("\n");
+    for (size_t row = 0; row < n; row++) {
+        int row_total = 0;
+        for (size_t col = 0; col < n; col++) {
+            row_total += report.confusion[row * n + col];
+        }
+        if (row_total == 0) {
+            continue;
+        }
+        printf("%4c ", report.classes[row]);
+        for (size_t col = 0; col < n; col++) {
+            int value = report.confusion[row * n + col];
+            if (value == 0) {
+                printf("%4s", ".");
+            } else {
+                printf("%4d", value);
+            }
+        }
+        printf("\n");
+    }
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s DATASET [--repeat N] [--warmup N] [--min-accuracy PCT] [--profile [csv]] [--verbose]\n",
+            argv0);
+}
+
+int main(int argc, char **argv) {
+    const char *dataset = nullptr;
+    int repeat = 5;
+    int warmup = 10;
+    double min_accuracy = -1.0;
+    bool profile = false;
+    bool profile_csv = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--min-accuracy") == 0 && i + 1 < argc) {
+            min_accuracy = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+            if (i + 1 < argc && strcmp(argv[i + 1], "csv") == 0) {
+                profile_csv = true;
+                i++;
+            }
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            esp_log_level_set("*", ESP_LOG_INFO);
+        } else if (argv[i][0] != '-' && dataset == nullptr) {
+            dataset = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (dataset == nullptr) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<Sample> samples;
+    if (!load_dataset(dataset, samples) || samples.empty()) {
+        fprintf(stderr, "no samples found in %s\n", dataset);
+        return 2;
+    }
+
+    int64_t start = esp_timer_get_time();
+    if (!init_models()) {
+        fprintf(stderr, "model initialization failed\n");
+        return 2;
+    }
+    printf("init_models: %.6f s\n", (esp_timer_get_time() - start) / 1e6);
+
+    ModelReport reports[2];
+    reports[0].name = "letter";
+    reports[0].classes = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    reports[1].name = "digit";
+    reports[1].classes = "0123456789:";
+    for (ModelReport &report : reports) {
+        report.confusion.assign(report.classes.size() * report.classes.size(), 0);
+    }
+
+    // Calentar cachés y el asignador antes de medir
+    for (int i = 0; i < warmup; i++) {
+        const Sample &sample = samples[i % samples.size()];
+        CharCrop crop = {sample.pixels.data(), (size_t)sample.width, 0, 0, sample.width, sample.height};
+        char result;
+        run_model_batch(&crop, &sample.is_letter, 1, &result);
+    }
+    // El perfil solo cuenta las pasadas medidas
+    model_profile_reset();
+
+    // Un recorte por llamada: cada llamada es exactamente un Invoke
+    for (int pass = 0; pass < repeat; pass++) {
+        for (const Sample &sample : samples) {
+            ModelReport &report = reports[sample.is_letter ? 0 : 1];
+            CharCrop crop = {sample.pixels.data(), (size_t)sample.width, 0, 0, sample.width, sample.height};
+            char result = 0;
+
+            auto t0 = std::chrono::steady_clock::now();
+            run_model_batch(&crop, &sample.is_letter, 1, &result);
+            auto t1 = std::chrono::steady_clock::now();
+            report.latencies_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+
+            if (pass > 0) {
+                continue;
+            }
+            report.samples++;
+            size_t expected = report.classes.find(sample.label);
+            size_t predicted = report.classes.find(result);
+            if (expected == std::string::npos || predicted == std::string::npos) {
+                report.unknown++;
+                continue;
+            }
+            report.confusion[expected * report.classes.size() + predicted]++;
+            if (expected == predicted) {
+                report.correct++;
+            } else {
+                ESP_LOGI("BENCH", "%s: expected %c, got %c", sample.path.c_str(), sample.label, result);
+            }
+        }
+    }
+
+    if (profile) {
+        model_profile_dump(profile_csv);
+    }
+
+    int status = 0;
+    for (ModelReport &report : reports) {
+        print_report(report);
+        if (min_accuracy >= 0.0 && report.samples > 0 && 100.0 * report.correct / report.samples < min_accuracy) {
+            printf("%s model below the required accuracy of %.2f%%\n", report.name, min_accuracy);
+            status = 1;
+        }
+    }
+    return status;
+}
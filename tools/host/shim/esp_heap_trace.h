@@ -0,0 +1,2 @@
+// pipeline_runner.cpp lo incluye para las trazas de heap comentadas
+#pragma once
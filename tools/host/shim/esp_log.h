@@ -0,0 +1,37 @@
+// ESP_LOGx sobre stderr para la build de host. El nivel se ajusta con
+// esp_log_level_set como en el ESP32 (por defecto solo advertencias y errores).
+#pragma once
+#include <stdio.h>
+
+typedef enum
+{
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+inline esp_log_level_t host_log_level = ESP_LOG_WARN;
+
+inline void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    (void)tag;
+    host_log_level = level;
+}
+
+#define HOST_LOG(level, letter, tag, format, ...)                                        \
+    do                                                                                   \
+    {                                                                                    \
+        if (host_log_level >= (level))                                                   \
+        {                                                                                \
+            fprintf(stderr, letter " (%s) " format "\n", tag, ##__VA_ARGS__);            \
+        }                                                                                \
+    } while (0)
+
+#define ESP_LOGE(tag, format, ...) HOST_LOG(ESP_LOG_ERROR, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) HOST_LOG(ESP_LOG_WARN, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) HOST_LOG(ESP_LOG_INFO, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) HOST_LOG(ESP_LOG_DEBUG, "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) HOST_LOG(ESP_LOG_VERBOSE, "V", tag, format, ##__VA_ARGS__)
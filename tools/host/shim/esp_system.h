@@ -0,0 +1,2 @@
+// Sin equivalente en el host
+#pragma once
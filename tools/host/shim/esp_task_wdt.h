@@ -0,0 +1,2 @@
+// Sin watchdog en el host
+#pragma once
@@ -0,0 +1,10 @@
+#pragma once
+#include <stdint.h>
+#include <chrono>
+
+// Microsegundos de un reloj monótono, como el temporizador del ESP32
+inline int64_t esp_timer_get_time(void)
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,9 @@
+// tf_model.cpp no usa FreeRTOS directamente; basta con que el include exista.
+// pipeline_runner.cpp solo consulta el heap libre para sus logs.
+#pragma once
+#include <stddef.h>
+
+inline size_t xPortGetFreeHeapSize(void)
+{
+    return 0;
+}
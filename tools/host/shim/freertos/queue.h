@@ -0,0 +1,2 @@
+// inference_worker.cpp sin CONFIG_PLATE_INFERENCE_WORKER no usa colas
+#pragma once
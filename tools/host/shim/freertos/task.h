@@ -0,0 +1,6 @@
+#pragma once
+#include "FreeRTOS.h"
+
+// inference_worker.h guarda la tarea que espera cada patente; en el host la
+// tarea de inferencia no existe y todo se clasifica en el hilo que llama
+typedef void *TaskHandle_t;
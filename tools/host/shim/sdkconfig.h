@@ -0,0 +1,24 @@
+// Configuración fija de la build de host: backend TFLM con kernels de
+// referencia y modelos compilados en el binario (tf_model_data.cc).
+#pragma once
+
+#define CONFIG_PLATE_BACKEND_TFLM 1
+#define CONFIG_PLATE_MODEL_SOURCE_EMBEDDED 1
+#define CONFIG_PLATE_ARENA_LAYOUT_SEPARATE 1
+
+// En x86-64 los punteros ocupan el doble que en el ESP32 y las estructuras
+// persistentes del intérprete crecen en proporción
+#define CONFIG_PLATE_LETTER_ARENA_SIZE 131072
+#define CONFIG_PLATE_NUMBER_ARENA_SIZE 131072
+
+// Perfil por operador, volcado a pedido (plate_host_bench --profile). La
+// biblioteca tflm se compila con TF_LITE_USE_CTIME: los ticks son de clock().
+#define CONFIG_PLATE_OP_PROFILE 1
+#define CONFIG_PLATE_OP_PROFILE_DUMP_INTERVAL 0
+
+// Pipeline completo (plate_filter_bench)
+#define CONFIG_PLATE_JOINT_DECODER 1
+#define CONFIG_PLATE_DECODER_DROP_PENALTY 5
+#define CONFIG_PLATE_DT_SIGMA_SPACE 4
+#define CONFIG_PLATE_DT_SIGMA_COLOR 36
+#define CONFIG_PLATE_DT_ITERATIONS 2
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Empaqueta los modelos .tflite en la imagen de la partición de modelos.
+
+La imagen lleva una cabecera (main/include/model_partition.h) con nombre,
+versión, forma de entrada, mapa de clases y CRC-32 de cada modelo, seguida de
+los flatbuffers alineados a 16 bytes. El firmware la mapea en memoria y se la
+pasa al intérprete sin copias.
+
+Uso:
+    tools/pack_models.py --model letter=main/tf_model_data.cc:model_tflite \\
+                         --model number=main/tf_model_data.cc:number_model_tflite \\
+                         --version 3 --out build/models.bin
+    parttool.py write_partition --partition-name models --input build/models.bin
+
+Los modelos aceptan las mismas fuentes que tools/tflite_to_cc.py (.tflite o
+`archivo.cc:símbolo`). Por defecto los modelos cuyo nombre empieza con
+"letter" mapean la clase i a 'A'+i, el modelo combinado "plate" a A-Z seguido
+de 0-9 y el resto a '0'+i; --class-map lo cambia.
+
+Los modelos con salida temprana se empaquetan como dos entradas: la cabeza
+("letter-head", con las clases como primera salida y los rasgos como segunda) y
+la cola ("letter-tail"), cuya entrada son esos rasgos. Una entrada de rasgos
+[batch, n] se registra como n x 1 x 1.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from tflite_to_cc import load_model, read_model_source  # noqa: E402
+
+MAGIC = 0x444D4C50  # "PLMD"
+FORMAT_VERSION = 1
+MAX_MODELS = 8
+NAME_LEN = 16
+CLASS_MAP_LEN = 40
+ALIGNMENT = 16
+ALPHABET = 'ABCDEFGHIJKLMNOPQRSTUVWXYZ'
+DIGITS = '0123456789'
+
+HEADER_FORMAT = '<IHHII'
+ENTRY_FORMAT = '<%dsIIIIHHHH%ds' % (NAME_LEN, CLASS_MAP_LEN)
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT) + MAX_MODELS * struct.calcsize(ENTRY_FORMAT)
+
+
+def align(value):
+    return (value + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+
+def default_class_map(name, num_classes):
+    if name == 'plate':
+        # Modelo combinado: letras y luego dígitos
+        return (ALPHABET + DIGITS)[:num_classes]
+    first = 'A' if name.startswith('letter') else '0'
+    return ''.join(chr(ord(first) + i) for i in range(num_classes))
+
+
+def describe(name, data, class_map):
+    tensors, _, inputs, outputs = load_model(data)
+    shape = tensors[inputs[0]].shape
+    if len(shape) == 2:
+        # Cola de un modelo con salida temprana: rasgos planos
+        shape = [shape[0], 1, shape[1], 1]
+    if len(shape) != 4:
+        sys.exit('%s: expected a [batch, height, width, channels] or [batch, features] input, got %s' % (name, shape))
+    out_shape = tensors[outputs[0]].shape
+    num_classes = out_shape[-1]
+    class_map = class_map if class_map is not None else default_class_map(name, num_classes)
+    if len(class_map) != num_classes:
+        sys.exit('%s: class map has %d entries but the model has %d classes' % (name, len(class_map), num_classes))
+    if len(class_map) >= CLASS_MAP_LEN or len(name) >= NAME_LEN:
+        sys.exit('%s: name or class map too long' % name)
+    return shape[2], shape[1], shape[3], num_classes, class_map
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--model', action='append', required=True,
+                        help='NAME=PATH.tflite or NAME=FILE.cc:SYMBOL')
+    parser.add_argument('--class-map', action='append', default=[],
+                        help='NAME=CHARS, one character per class')
+    parser.add_argument('--version', type=int, default=1, help='version stored in every entry')
+    parser.add_argument('--partition-size', type=lambda v: int(v, 0), default=None,
+                        help='fail if the image does not fit in this many bytes')
+    parser.add_argument('--out', required=True)
+    args = parser.parse_args()
+
+    if len(args.model) > MAX_MODELS:
+        sys.exit('at most %d models fit in the header' % MAX_MODELS)
+    class_maps = dict(spec.split('=', 1) for spec in args.class_map)
+
+    entries = []
+    blobs = []
+    offset = align(HEADER_SIZE)
+    for spec in args.model:
+        name, source = spec.split('=', 1)
+        data, _ = read_model_source(source)
+        width, height, channels, num_classes, class_map = describe(name, data, class_maps.get(name))
+        entries.append(struct.pack(ENTRY_FORMAT, name.encode(), args.version, offset, len(data),
+                                   zlib.crc32(data) & 0xffffffff, width, height, channels, num_classes,
+                                   class_map.encode()))
+        blobs.append((offset, data))
+        print('%-12s v%d: %7d bytes at 0x%06x, input %dx%dx%d, classes "%s"' % (
+            name, args.version, len(data), offset, width, height, channels, class_map))
+        offset = align(offset + len(data))
+
+    table = b''.join(entries)
+    image = bytearray(offset)
+    struct.pack_into(HEADER_FORMAT, image, 0, MAGIC, FORMAT_VERSION, len(entries), zlib.crc32(table) & 0xffffffff, 0)
+    image[struct.calcsize(HEADER_FORMAT):struct.calcsize(HEADER_FORMAT) + len(table)] = table
+    for blob_offset, data in blobs:
+        image[blob_offset:blob_offset + len(data)] = data
+
+    if args.partition_size is not None and len(image) > args.partition_size:
+        sys.exit('model image is %d bytes, partition only has %d' % (len(image), args.partition_size))
+
+    with open(args.out, 'wb') as f:
+        f.write(image)
+    print('wrote %s (%d bytes)' % (args.out, len(image)))
+
+
+if __name__ == '__main__':
+    main()
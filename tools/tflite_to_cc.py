@@ -0,0 +1,974 @@
+#!/usr/bin/env python3
+"""Genera C++ sin intérprete a partir de los modelos .tflite de caracteres.
+
+Cada modelo se convierte en una función que llama directamente a los kernels de
+esp-nn con formas constantes, multiplicadores precalculados y activaciones en un
+buffer estático. Las operaciones elemento a elemento (Mul/Add con escalar,
+LeakyRelu, Quantize) se resuelven en tiempo de generación como tablas de 256
+valores, y las que van seguidas se combinan en una sola tabla.
+
+Los FullyConnected con pesos int4 (tensores INT4 del modelo, o int8 recuantizados
+con --int4-fc) usan un kernel propio que lee los pesos empaquetados de a dos por
+byte con escala por canal de salida: la capa densa grande es la que más ancho de
+banda de flash consume y así lee la mitad de bytes.
+
+Con --sparse-threshold, las Conv2D y FullyConnected podadas por bloques (filas de
+pesos con tramos de 16 ceros consecutivos) se emiten con kernels que solo
+recorren los bloques no nulos, cuando la fracción de bloques nulos supera el umbral.
+
+Uso:
+    tools/tflite_to_cc.py --model letter=main/tf_model_data.cc:model_tflite \\
+                          --model number=main/tf_model_data.cc:number_model_tflite \\
+                          --out-dir main/generated
+
+Un modelo puede venir de un .tflite o de un array C dentro de un .cc
+(`archivo.cc:símbolo`). En el segundo caso los pesos no se duplican: el código
+generado apunta a los datos dentro de ese mismo array.
+
+Solo usa la biblioteca estándar de Python.
+"""
+
+import argparse
+import math
+import os
+import re
+import struct
+import sys
+
+# ---------------------------------------------------------------------------
+# Lectura mínima de flatbuffers (esquema TFLite)
+# ---------------------------------------------------------------------------
+
+
+class Table:
+    def __init__(self, buf, pos):
+        self.buf = buf
+        self.pos = pos
+        self.vtable = pos - struct.unpack_from('<i', buf, pos)[0]
+        self.vtable_len = struct.unpack_from('<H', buf, self.vtable)[0]
+
+    def _offset(self, field):
+        entry = 4 + 2 * field
+        if entry >= self.vtable_len:
+            return 0
+        return struct.unpack_from('<H', self.buf, self.vtable + entry)[0]
+
+    def scalar(self, field, fmt, default=0):
+        off = self._offset(field)
+        if not off:
+            return default
+        return struct.unpack_from('<' + fmt, self.buf, self.pos + off)[0]
+
+    def _indirect(self, field):
+        off = self._offset(field)
+        if not off:
+            return None
+        p = self.pos + off
+        return p + struct.unpack_from('<I', self.buf, p)[0]
+
+    def table(self, field):
+        p = self._indirect(field)
+        return Table(self.buf, p) if p is not None else None
+
+    def vector(self, field):
+        """Devuelve (posición de los datos, cantidad de elementos) o None."""
+        p = self._indirect(field)
+        if p is None:
+            return None
+        return p + 4, struct.unpack_from('<I', self.buf, p)[0]
+
+    def scalars(self, field, fmt):
+        v = self.vector(field)
+        if v is None:
+            return []
+        size = struct.calcsize(fmt)
+        return [struct.unpack_from('<' + fmt, self.buf, v[0] + i * size)[0] for i in range(v[1])]
+
+    def tables(self, field):
+        v = self.vector(field)
+        if v is None:
+            return []
+        out = []
+        for i in range(v[1]):
+            p = v[0] + 4 * i
+            out.append(Table(self.buf, p + struct.unpack_from('<I', self.buf, p)[0]))
+        return out
+
+    def string(self, field):
+        v = self.vector(field)
+        return self.buf[v[0]:v[0] + v[1]].decode() if v else ''
+
+
+# Códigos de operación y tipos del esquema TFLite
+OP_ADD = 0
+OP_CONV_2D = 3
+OP_DEQUANTIZE = 6
+OP_FULLY_CONNECTED = 9
+OP_MAX_POOL_2D = 17
+OP_MUL = 18
+OP_RELU = 19
+OP_RESHAPE = 22
+OP_SOFTMAX = 25
+OP_LEAKY_RELU = 98
+OP_QUANTIZE = 114
+
+TYPE_INT32 = 2
+TYPE_INT8 = 9
+TYPE_INT4 = 17
+
+ACT_NONE = 0
+ACT_RELU = 1
+ACT_RELU6 = 3
+
+PADDING_SAME = 0
+
+
+class Tensor:
+    def __init__(self, index, table, buffers):
+        self.index = index
+        self.name = table.string(3)
+        self.shape = table.scalars(0, 'i')
+        self.type = table.scalar(1, 'b')
+        quant = table.table(4)
+        self.scales = quant.scalars(2, 'f') if quant else []
+        self.zero_points = quant.scalars(3, 'q') if quant else []
+        self.is_sparse = table.table(6) is not None
+        data = buffers[table.scalar(2, 'I')].vector(0)
+        self.data_offset = data[0] if data and data[1] else None
+        self.data_size = data[1] if data else 0
+
+    @property
+    def is_const(self):
+        return self.data_offset is not None
+
+    @property
+    def scale(self):
+        return self.scales[0]
+
+    @property
+    def zero_point(self):
+        return self.zero_points[0] if self.zero_points else 0
+
+    @property
+    def elements(self):
+        n = 1
+        for d in self.shape:
+            n *= d
+        return n
+
+
+class Operator:
+    def __init__(self, table, opcodes):
+        self.code = opcodes[table.scalar(0, 'I')]
+        self.inputs = [i for i in table.scalars(1, 'i') if i >= 0]
+        self.outputs = table.scalars(2, 'i')
+        self.options = table.table(4)
+
+
+def load_model(buf):
+    model = Table(buf, struct.unpack_from('<I', buf, 0)[0])
+    opcodes = []
+    for code in model.tables(1):
+        # builtin_code (campo 3) reemplaza a deprecated_builtin_code (campo 0) desde 127
+        opcodes.append(max(code.scalar(0, 'b'), code.scalar(3, 'i')))
+    buffers = model.tables(4)
+    subgraph = model.tables(2)[0]
+    tensors = [Tensor(i, t, buffers) for i, t in enumerate(subgraph.tables(0))]
+    operators = [Operator(t, opcodes) for t in subgraph.tables(3)]
+    return tensors, operators, subgraph.scalars(1, 'i'), subgraph.scalars(2, 'i')
+
+
+def read_model_source(source):
+    """Devuelve (bytes del modelo, símbolo C o None)."""
+    if ':' in source and not os.path.exists(source):
+        path, symbol = source.rsplit(':', 1)
+        text = open(path).read()
+        match = re.search(r'\b' + re.escape(symbol) + r'\[\][^=]*=\s*\{(.*?)\};', text, re.S)
+        if not match:
+            sys.exit('symbol %s not found in %s' % (symbol, path))
+        data = bytes(int(h, 16) for h in re.findall(r'0x([0-9a-fA-F]{2})', match.group(1)))
+        return data, symbol
+    return open(source, 'rb').read(), None
+
+
+# ---------------------------------------------------------------------------
+# Aritmética entera de referencia de TFLM (para multiplicadores y tablas)
+# ---------------------------------------------------------------------------
+
+INT32_MIN = -(1 << 31)
+INT32_MAX = (1 << 31) - 1
+
+
+def f32(x):
+    return struct.unpack('<f', struct.pack('<f', x))[0]
+
+
+def tflite_round(x):
+    return int(math.floor(x + 0.5)) if x >= 0 else -int(math.floor(-x + 0.5))
+
+
+def quantize_multiplier(real):
+    if real == 0.0:
+        return 0, 0
+    q, shift = math.frexp(real)
+    q_fixed = tflite_round(q * (1 << 31))
+    if q_fixed == (1 << 31):
+        q_fixed //= 2
+        shift += 1
+    if shift < -31:
+        shift = 0
+        q_fixed = 0
+    if shift > 30:
+        shift = 30
+        q_fixed = (1 << 31) - 1
+    return q_fixed, shift
+
+
+def trunc_div(a, b):
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b >= 0) else -q
+
+
+def saturating_rounding_doubling_high_mul(a, b):
+    if a == INT32_MIN and b == INT32_MIN:
+        return INT32_MAX
+    ab = a * b
+    nudge = (1 << 30) if ab >= 0 else 1 - (1 << 30)
+    return trunc_div(ab + nudge, 1 << 31)
+
+
+def rounding_divide_by_pot(x, exponent):
+    mask = (1 << exponent) - 1
+    remainder = x & mask
+    threshold = (mask >> 1) + (1 if x < 0 else 0)
+    return (x >> exponent) + (1 if remainder > threshold else 0)
+
+
+def multiply_by_quantized_multiplier(x, multiplier, shift):
+    left = shift if shift > 0 else 0
+    right = -shift if shift < 0 else 0
+    return rounding_divide_by_pot(saturating_rounding_doubling_high_mul(x * (1 << left), multiplier), right)
+
+
+def clamp(v, lo=-128, hi=127):
+    return max(lo, min(hi, v))
+
+
+def activation_range(activation, out):
+    lo, hi = -128, 127
+    if activation == ACT_RELU:
+        lo = max(lo, out.zero_point)
+    elif activation == ACT_RELU6:
+        lo = max(lo, out.zero_point)
+        hi = min(hi, out.zero_point + tflite_round(6.0 / out.scale))
+    elif activation != ACT_NONE:
+        sys.exit('unsupported fused activation %d' % activation)
+    return lo, hi
+
+
+def weight_values(tensor, buf):
+    """Pesos como enteros con signo; los int4 vienen de a dos por byte, nibble bajo primero."""
+    if tensor.type == TYPE_INT4:
+        values = []
+        for packed in buf[tensor.data_offset:tensor.data_offset + (tensor.elements + 1) // 2]:
+            values.append(((packed & 0x0f) ^ 8) - 8)
+            values.append(((packed >> 4) ^ 8) - 8)
+        return values[:tensor.elements]
+    return list(struct.unpack_from('<%db' % tensor.elements, buf, tensor.data_offset))
+
+
+SPARSE_BLOCK = 16
+
+
+def block_sparse_rows(values, rows, row_len):
+    """Bloques de SPARSE_BLOCK pesos por fila con algún valor distinto de cero.
+
+    Devuelve (inicio de cada fila en la lista de bloques, columna de inicio de cada
+    bloque, valores de los bloques completados con ceros)."""
+    ptr, cols, data = [0], [], []
+    for r in range(rows):
+        row = values[r * row_len:(r + 1) * row_len]
+        for c in range(0, row_len, SPARSE_BLOCK):
+            block = row[c:c + SPARSE_BLOCK]
+            if any(block):
+                cols.append(c)
+                data.extend(block + [0] * (SPARSE_BLOCK - len(block)))
+        ptr.append(len(cols))
+    return ptr, cols, data
+
+
+def pack_int4(values):
+    values = list(values) + [0] * (len(values) % 2)
+    return [(values[i] & 0x0f) | ((values[i + 1] & 0x0f) << 4) for i in range(0, len(values), 2)]
+
+
+def const_scalar(tensor, buf):
+    if tensor.type != TYPE_INT8 or tensor.elements != 1:
+        sys.exit('only int8 scalar constants are supported in elementwise ops (%s)' % tensor.name)
+    return struct.unpack_from('<b', buf, tensor.data_offset)[0]
+
+
+def lut_for_op(op, tensors, buf):
+    """Tabla de 256 entradas (índice = entrada + 128) para una op int8 unaria."""
+    out = tensors[op.outputs[0]]
+    act = op.options.scalar(0, 'b') if op.options else ACT_NONE
+
+    if op.code in (OP_MUL, OP_ADD):
+        a, b = (tensors[i] for i in op.inputs)
+        if a.is_const:
+            a, b = b, a
+        c = const_scalar(b, buf)
+        lo, hi = activation_range(act, out)
+        table = []
+        if op.code == OP_MUL:
+            mult, shift = quantize_multiplier(float(a.scale) * float(b.scale) / float(out.scale))
+            for x in range(-128, 128):
+                v = multiply_by_quantized_multiplier((x - a.zero_point) * (c - b.zero_point), mult, shift)
+                table.append(clamp(v + out.zero_point, lo, hi))
+        else:
+            left_shift = 20
+            twice_max = 2 * max(float(a.scale), float(b.scale))
+            m1, s1 = quantize_multiplier(float(a.scale) / twice_max)
+            m2, s2 = quantize_multiplier(float(b.scale) / twice_max)
+            mo, so = quantize_multiplier(twice_max / ((1 << left_shift) * float(out.scale)))
+            scaled_c = rounding_divide_by_pot(
+                saturating_rounding_doubling_high_mul((c - b.zero_point) * (1 << left_shift), m2), -s2)
+            for x in range(-128, 128):
+                scaled_x = rounding_divide_by_pot(
+                    saturating_rounding_doubling_high_mul((x - a.zero_point) * (1 << left_shift), m1), -s1)
+                raw = rounding_divide_by_pot(saturating_rounding_doubling_high_mul(scaled_x + scaled_c, mo), -so)
+                table.append(clamp(raw + out.zero_point, lo, hi))
+        return table
+
+    inp = tensors[op.inputs[0]]
+    if op.code == OP_LEAKY_RELU:
+        alpha = op.options.scalar(0, 'f')
+        ma, sa = quantize_multiplier(f32(f32(inp.scale * alpha) / out.scale))
+        mi, si = quantize_multiplier(f32(inp.scale / out.scale))
+        table = []
+        for x in range(-128, 128):
+            v = x - inp.zero_point
+            if v >= 0:
+                r = multiply_by_quantized_multiplier(v, mi, si)
+            else:
+                r = multiply_by_quantized_multiplier(v, ma, sa)
+            table.append(clamp(out.zero_point + r))
+        return table
+
+    if op.code == OP_RELU:
+        lo, hi = activation_range(ACT_RELU, out)
+        m, s = quantize_multiplier(float(inp.scale) / float(out.scale))
+        return [clamp(out.zero_point + multiply_by_quantized_multiplier(x - inp.zero_point, m, s), lo, hi)
+                for x in range(-128, 128)]
+
+    if op.code == OP_QUANTIZE:
+        if inp.type != TYPE_INT8 or out.type != TYPE_INT8:
+            sys.exit('only int8 -> int8 Quantize is supported')
+        m, s = quantize_multiplier(float(inp.scale) / float(out.scale))
+        return [clamp(multiply_by_quantized_multiplier(x - inp.zero_point, m, s) + out.zero_point)
+                for x in range(-128, 128)]
+
+    return None
+
+
+def is_elementwise(op, tensors):
+    if op.code in (OP_LEAKY_RELU, OP_RELU, OP_QUANTIZE):
+        return True
+    if op.code in (OP_MUL, OP_ADD):
+        return any(tensors[i].is_const for i in op.inputs)
+    return False
+
+
+# ---------------------------------------------------------------------------
+# Generación de código
+# ---------------------------------------------------------------------------
+
+
+class ModelGen:
+    def __init__(self, name, buf, symbol, int4_fc_min=None, sparse_threshold=None):
+        self.name = name
+        self.int4_fc_min = int4_fc_min
+        self.sparse_threshold = sparse_threshold
+        self.buf = buf
+        self.symbol = symbol
+        self.tensors, self.ops, inputs, outputs = load_model(buf)
+        if len(inputs) != 1 or len(outputs) != 1:
+            sys.exit('%s: only single input/output models are supported' % name)
+        self.input = self.tensors[inputs[0]]
+        self.output = self.tensors[outputs[0]]
+        if self.input.type != TYPE_INT8 or self.output.type != TYPE_INT8:
+            sys.exit('%s: only int8 input/output models are supported' % name)
+        if self.input.shape[0] != 1:
+            sys.exit('%s: only batch 1 models are supported' % name)
+        if any(t.is_sparse for t in self.tensors):
+            sys.exit('%s: TFLite sparse tensors are not supported; export the pruned weights dense' % name)
+        self.consts = []   # declaraciones de constantes
+        self.body = []     # sentencias de la función invoke
+        self.scratch = []  # expresiones de tamaño de scratch de conv
+        self.max_activation = 0
+        self.kernels = set()  # kernels propios que usa el modelo (ver KERNEL_PRELUDES)
+        self.conv_count = 0
+
+    # Datos constantes: si el modelo viene de un array C, se apunta dentro de él.
+    # Los pesos int4 que van a esp-nn se desempaquetan a int8 en tiempo de generación.
+    def data_ref(self, tensor, ctype, label):
+        if (self.symbol is not None and tensor.type != TYPE_INT4
+                and (ctype != 'int32_t' or tensor.data_offset % 4 == 0)):
+            return 'reinterpret_cast<const %s *>(%s + %d)' % (ctype, self.symbol, tensor.data_offset)
+        name = '%s_%s' % (self.name, label)
+        if ctype == 'int32_t':
+            values = struct.unpack_from('<%di' % tensor.elements, self.buf, tensor.data_offset)
+        else:
+            values = weight_values(tensor, self.buf)
+        self.consts.append('alignas(16) static const %s %s[%d] = {\n%s\n};' % (ctype, name, len(values), wrap(values)))
+        return name
+
+    def emit(self, line):
+        self.body.append('    ' + line)
+
+    def generate(self):
+        # El modelo es una cadena: cada op toma la salida de la anterior. Se usan
+        # dos buffers alternados; las ops elemento a elemento se aplican en el lugar.
+        current = 'input'
+        current_tensor = self.input
+        pending_lut = None
+        lut_count = 0
+        ping = 0
+        ops = self.ops
+
+        def buffer_name(index):
+            return 'activations + %d' % (index * self.slot_size)
+
+        self.slot_size = align(max(t.elements for t in self.tensors if not t.is_const and t.type == TYPE_INT8), 16)
+
+        def flush_lut():
+            nonlocal current, pending_lut, lut_count, ping
+            if pending_lut is None:
+                return
+            name = '%s_lut%d' % (self.name, lut_count)
+            lut_count += 1
+            self.consts.append('static const int8_t %s[256] = {\n%s\n};' % (name, wrap(pending_lut)))
+            size = current_tensor.elements
+            if current == 'input':
+                dst = buffer_name(ping)
+                ping ^= 1
+                self.emit('apply_lut(%s, input, %s, %d);' % (name, dst, size))
+                current = dst
+            else:
+                self.emit('apply_lut(%s, %s, %s, %d);' % (name, current, current, size))
+            pending_lut = None
+
+        for i, op in enumerate(ops):
+            data_inputs = [self.tensors[t] for t in op.inputs if not self.tensors[t].is_const]
+            if not data_inputs or data_inputs[0].index != current_tensor.index:
+                sys.exit('%s: op %d does not consume the previous output; only chain models are supported'
+                         % (self.name, i))
+            out = self.tensors[op.outputs[0]]
+
+            if is_elementwise(op, self.tensors):
+                table = lut_for_op(op, self.tensors, self.buf)
+                if pending_lut is None:
+                    pending_lut = table
+                else:
+                    pending_lut = [table[v + 128] for v in pending_lut]
+                current_tensor = out
+                continue
+
+            flush_lut()
+
+            if op.code == OP_RESHAPE:
+                current_tensor = out
+                continue
+
+            if op.code == OP_SOFTMAX:
+                if op.outputs[0] != self.output.index:
+                    sys.exit('%s: Softmax is only supported as the last op' % self.name)
+                if out.elements > 64:
+                    sys.exit('%s: Softmax over more than 64 classes is not supported' % self.name)
+                beta = op.options.scalar(0, 'f', 1.0) if op.options else 1.0
+                self.emit('softmax_s8(%s, output, %d, %.9ef, %.9ef, %.9ef, %d);' % (
+                    current, out.elements, current_tensor.scale, beta, out.scale, out.zero_point))
+                current = 'output'
+                current_tensor = out
+                continue
+
+            dst = buffer_name(ping)
+            ping ^= 1
+            if op.code == OP_CONV_2D:
+                self.gen_conv(op, current, dst, current_tensor, out)
+            elif op.code == OP_MAX_POOL_2D:
+                self.gen_max_pool(op, current, dst, current_tensor, out)
+            elif op.code == OP_FULLY_CONNECTED:
+                self.gen_fully_connected(op, current, dst, current_tensor, out)
+            else:
+                sys.exit('%s: unsupported op code %d' % (self.name, op.code))
+            current = dst
+            current_tensor = out
+
+        flush_lut()
+        if current != 'output':
+            self.emit('memcpy(output, %s, %d);' % (current, self.output.elements))
+        self.max_activation = 2 * self.slot_size
+
+    def gen_conv(self, op, src, dst, inp, out):
+        filt = self.tensors[op.inputs[1]]
+        bias = self.tensors[op.inputs[2]] if len(op.inputs) > 2 else None
+        o = op.options
+        padding = o.scalar(0, 'b')
+        stride_w, stride_h = o.scalar(1, 'i', 1), o.scalar(2, 'i', 1)
+        act = o.scalar(3, 'b')
+        if o.scalar(4, 'i', 1) != 1 or o.scalar(5, 'i', 1) != 1:
+            sys.exit('%s: dilated convolutions are not supported' % self.name)
+        _, in_h, in_w, in_c = inp.shape
+        _, out_h, out_w, out_c = out.shape
+        _, f_h, f_w, _ = filt.shape
+        pad_h = compute_padding(padding, stride_h, in_h, f_h, out_h)
+        pad_w = compute_padding(padding, stride_w, in_w, f_w, out_w)
+        lo, hi = activation_range(act, out)
+
+        mults, shifts = [], []
+        for c in range(out_c):
+            filter_scale = filt.scales[c] if len(filt.scales) > 1 else filt.scales[0]
+            m, s = quantize_multiplier(float(inp.scale) * float(filter_scale) / float(out.scale))
+            mults.append(m)
+            shifts.append(s)
+        label = 'conv%d' % self.conv_count
+        self.conv_count += 1
+        self.consts.append('static int32_t %s_%s_mult[%d] = {\n%s\n};' % (self.name, label, out_c, wrap(mults)))
+        self.consts.append('static int32_t %s_%s_shift[%d] = {\n%s\n};' % (self.name, label, out_c, wrap(shifts)))
+
+        # Un bloque nunca cruza de una posición del filtro a la siguiente
+        sparse = self.sparse_blocks(filt, out_c, f_h * f_w * in_c) if in_c % SPARSE_BLOCK == 0 else None
+        if sparse is not None:
+            prefix = '%s_%s' % (self.name, label)
+            self.emit_sparse_consts(prefix, sparse)
+            bias_ref = self.data_ref(bias, 'int32_t', label + '_bias') if bias is not None else 'nullptr'
+            self.emit('conv_sparse_s8(%s, %d, %d, %d, %d, %d, %d, %d, %d, %d, %s_block_ptr, %s_block_col, '
+                      '%s_block_values, %s, %s, %d, %d, %d, %d, %s_shift, %s_mult, %d, %d);' % (
+                          src, in_w, in_h, in_c, -inp.zero_point, f_w, stride_w, stride_h, pad_w, pad_h,
+                          prefix, prefix, prefix, bias_ref, dst, out_w, out_h, out_c, out.zero_point,
+                          prefix, prefix, lo, hi))
+            self.kernels.add('sparse')
+            return
+        dims = ('{%d, %d, %d, 1}' % (in_w, in_h, in_c), '{%d, %d, 0, 0}' % (f_w, f_h),
+                '{%d, %d, %d, 1}' % (out_w, out_h, out_c))
+        params = '{%d, %d, {%d, %d}, {%d, %d}, {0, 0}, {%d, %d}}' % (
+            -inp.zero_point, out.zero_point, stride_w, stride_h, pad_w, pad_h, lo, hi)
+        self.consts.append('static const data_dims_t %s_%s_input_dims = %s;' % (self.name, label, dims[0]))
+        self.consts.append('static const data_dims_t %s_%s_filter_dims = %s;' % (self.name, label, dims[1]))
+        self.consts.append('static const data_dims_t %s_%s_output_dims = %s;' % (self.name, label, dims[2]))
+        self.consts.append('static const conv_params_t %s_%s_params = %s;' % (self.name, label, params))
+        self.consts.append('static const quant_data_t %s_%s_quant = {%s_%s_shift, %s_%s_mult};' % (
+            self.name, label, self.name, label, self.name, label))
+        self.scratch.append(label)
+
+        bias_ref = self.data_ref(bias, 'int32_t', label + '_bias') if bias is not None else 'nullptr'
+        self.emit('esp_nn_conv_s8(&%s_%s_input_dims, %s, &%s_%s_filter_dims, %s, %s, &%s_%s_output_dims, %s, '
+                  '&%s_%s_params, &%s_%s_quant);' % (
+                      self.name, label, src, self.name, label, self.data_ref(filt, 'int8_t', label + '_filter'),
+                      bias_ref, self.name, label, dst, self.name, label, self.name, label))
+
+    def gen_max_pool(self, op, src, dst, inp, out):
+        o = op.options
+        padding = o.scalar(0, 'b')
+        stride_w, stride_h = o.scalar(1, 'i', 1), o.scalar(2, 'i', 1)
+        f_w, f_h = o.scalar(3, 'i'), o.scalar(4, 'i')
+        lo, hi = activation_range(o.scalar(5, 'b'), out)
+        _, in_h, in_w, channels = inp.shape
+        _, out_h, out_w, _ = out.shape
+        pad_h = compute_padding(padding, stride_h, in_h, f_h, out_h)
+        pad_w = compute_padding(padding, stride_w, in_w, f_w, out_w)
+        self.emit('esp_nn_max_pool_s8(%s, %d, %d, %s, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d);' % (
+            src, in_w, in_h, dst, out_w, out_h, stride_w, stride_h, f_w, f_h, pad_w, pad_h, lo, hi, channels))
+
+    def gen_fully_connected(self, op, src, dst, inp, out):
+        weights = self.tensors[op.inputs[1]]
+        bias = self.tensors[op.inputs[2]] if len(op.inputs) > 2 else None
+        act = op.options.scalar(0, 'b') if op.options else ACT_NONE
+        lo, hi = activation_range(act, out)
+        out_features, row_len = weights.shape
+        sparse = self.sparse_blocks(weights, out_features, row_len)
+        if sparse is not None:
+            self.gen_fully_connected_sparse(src, dst, inp, out, weights, bias, lo, hi, sparse)
+            return
+        if weights.type == TYPE_INT4 or (self.int4_fc_min is not None and weights.elements >= self.int4_fc_min):
+            self.gen_fully_connected_s4(src, dst, inp, out, weights, bias, lo, hi)
+            return
+        # Igual que GetQuantizedConvolutionMultipler: el producto de escalas se hace en float
+        m, s = quantize_multiplier(float(f32(inp.scale * weights.scale)) / float(out.scale))
+        label = 'fc%d' % sum(1 for line in self.body if 'fully_connected' in line)
+        bias_ref = self.data_ref(bias, 'int32_t', label + '_bias') if bias is not None else 'nullptr'
+        self.emit('esp_nn_fully_connected_s8(%s, %d, %d, %s, %d, %s, %s, %d, %d, %d, %d, %d, %d);' % (
+            src, -inp.zero_point, row_len, self.data_ref(weights, 'int8_t', label + '_weights'),
+            -weights.zero_point, bias_ref, dst, out_features, out.zero_point, s, m, lo, hi))
+
+    def gen_fully_connected_s4(self, src, dst, inp, out, weights, bias, lo, hi):
+        out_features, row_len = weights.shape
+        if weights.zero_point != 0:
+            sys.exit('%s: int4 packing needs symmetric weights' % self.name)
+        values = weight_values(weights, self.buf)
+        biases = (struct.unpack_from('<%di' % out_features, self.buf, bias.data_offset) if bias is not None
+                  else [0] * out_features)
+
+        packed, folded_bias, mults, shifts = [], [], [], []
+        for c in range(out_features):
+            row = values[c * row_len:(c + 1) * row_len]
+            scale = weights.scales[c] if len(weights.scales) > 1 else weights.scale
+            row_bias = biases[c]
+            if weights.type != TYPE_INT4:
+                # Recuantizar la fila a int4 simétrico con su propia escala; el bias
+                # está en escala entrada*peso y se lleva a la nueva escala
+                peak = max(abs(v) for v in row)
+                new_scale = f32(scale * peak / 7) if peak else scale
+                row = [clamp(tflite_round(v * scale / new_scale), -8, 7) for v in row]
+                row_bias = tflite_round(row_bias * scale / new_scale)
+                scale = new_scale
+            # El offset de entrada es constante: su producto con la fila va al bias
+            folded_bias.append(row_bias - inp.zero_point * sum(row))
+            m, s = quantize_multiplier(float(f32(inp.scale * scale)) / float(out.scale))
+            mults.append(m)
+            shifts.append(s)
+            # Cada fila arranca en un byte para no partir nibbles entre canales
+            packed.extend(pack_int4(row))
+
+        label = 'fc%d' % sum(1 for line in self.body if 'fully_connected' in line)
+        prefix = '%s_%s' % (self.name, label)
+        self.consts.append('alignas(16) static const uint8_t %s_weights_s4[%d] = {\n%s\n};' % (
+            prefix, len(packed), wrap(packed)))
+        self.consts.append('static const int32_t %s_bias_s4[%d] = {\n%s\n};' % (
+            prefix, out_features, wrap(folded_bias)))
+        self.consts.append('static const int32_t %s_mult[%d] = {\n%s\n};' % (prefix, out_features, wrap(mults)))
+        self.consts.append('static const int32_t %s_shift[%d] = {\n%s\n};' % (prefix, out_features, wrap(shifts)))
+        self.emit('fully_connected_s4(%s, %d, %s_weights_s4, %s_bias_s4, %s, %d, %d, %s_shift, %s_mult, %d, %d);' % (
+            src, row_len, prefix, prefix, dst, out_features, out.zero_point, prefix, prefix, lo, hi))
+        self.kernels.add('s4')
+        print('%s %s: %d weight bytes as int4 (%d as int8)' % (self.name, label, len(packed), weights.elements))
+
+    # Bloques no nulos del tensor de pesos si la fracción de bloques nulos supera
+    # el umbral; si no conviene el kernel disperso devuelve None
+    def sparse_blocks(self, weights, rows, row_len):
+        if self.sparse_threshold is None:
+            return None
+        values = weight_values(weights, self.buf)
+        ptr, cols, data = block_sparse_rows(values, rows, row_len)
+        total = rows * ((row_len + SPARSE_BLOCK - 1) // SPARSE_BLOCK)
+        zero_fraction = 1.0 - len(cols) / total
+        if zero_fraction * 100 < self.sparse_threshold or len(cols) > 0xffff or row_len > 0xffff:
+            return None
+        print('%s: %d of %d weight blocks are zero (%.0f%%), using the sparse kernel' % (
+            self.name, total - len(cols), total, zero_fraction * 100))
+        return ptr, cols, data
+
+    def emit_sparse_consts(self, prefix, sparse):
+        ptr, cols, data = sparse
+        self.consts.append('static const uint16_t %s_block_ptr[%d] = {\n%s\n};' % (prefix, len(ptr), wrap(ptr)))
+        self.consts.append('static const uint16_t %s_block_col[%d] = {\n%s\n};' % (
+            prefix, max(len(cols), 1), wrap(cols or [0])))
+        self.consts.append('alignas(16) static const int8_t %s_block_values[%d] = {\n%s\n};' % (
+            prefix, max(len(data), 1), wrap(data or [0])))
+
+    def gen_fully_connected_sparse(self, src, dst, inp, out, weights, bias, lo, hi, sparse):
+        out_features, row_len = weights.shape
+        if weights.zero_point != 0:
+            sys.exit('%s: sparse weights must be symmetric' % self.name)
+        values = weight_values(weights, self.buf)
+        biases = (struct.unpack_from('<%di' % out_features, self.buf, bias.data_offset) if bias is not None
+                  else [0] * out_features)
+        # Sin padding el offset de entrada es constante: su producto con la fila va al bias
+        folded_bias = [biases[c] - inp.zero_point * sum(values[c * row_len:(c + 1) * row_len])
+                       for c in range(out_features)]
+        m, s = quantize_multiplier(float(f32(inp.scale * weights.scale)) / float(out.scale))
+
+        label = 'fc%d' % sum(1 for line in self.body if 'fully_connected' in line)
+        prefix = '%s_%s' % (self.name, label)
+        self.emit_sparse_consts(prefix, sparse)
+        self.consts.append('static const int32_t %s_bias_folded[%d] = {\n%s\n};' % (
+            prefix, out_features, wrap(folded_bias)))
+        self.emit('fully_connected_sparse_s8(%s, %d, %s_block_ptr, %s_block_col, %s_block_values, %s_bias_folded, '
+                  '%s, %d, %d, %d, %d, %d, %d);' % (
+                      src, row_len, prefix, prefix, prefix, prefix, dst, out_features, out.zero_point, s, m, lo, hi))
+        self.kernels.add('sparse')
+
+    def scratch_exprs(self):
+        return ['esp_nn_get_conv_scratch_size(&{0}_{1}_input_dims, &{0}_{1}_filter_dims, '
+                '&{0}_{1}_output_dims, &{0}_{1}_params)'.format(self.name, label) for label in self.scratch]
+
+
+def compute_padding(padding, stride, in_size, filter_size, out_size):
+    if padding != PADDING_SAME:
+        return 0
+    pad = ((out_size - 1) * stride + filter_size - in_size) // 2
+    return pad if pad > 0 else 0
+
+
+def align(value, to):
+    return (value + to - 1) // to * to
+
+
+def wrap(values, per_line=12):
+    items = [str(v) for v in values]
+    lines = ['    ' + ', '.join(items[i:i + per_line]) + ',' for i in range(0, len(items), per_line)]
+    return '\n'.join(lines)
+
+
+HEADER_TEMPLATE = '''// Generado por tools/tflite_to_cc.py. No editar a mano.
+#ifndef CHAR_MODELS_GEN_H
+#define CHAR_MODELS_GEN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+{decls}
+// Buffer de activaciones que sirve a cualquiera de los modelos (nunca corren a la vez)
+constexpr size_t char_models_activation_size = {activation_size};
+
+#endif // CHAR_MODELS_GEN_H
+'''
+
+MODEL_DECL_TEMPLATE = '''// Modelo "{name}": entrada {in_shape} int8, salida {classes} clases
+constexpr int {name}_model_num_classes = {classes};
+constexpr float {name}_model_input_scale = {in_scale:.9e}f;
+constexpr int {name}_model_input_zero_point = {in_zp};
+constexpr float {name}_model_output_scale = {out_scale:.9e}f;
+constexpr int {name}_model_output_zero_point = {out_zp};
+// true si la salida son logits crudos (el modelo no termina en Softmax)
+constexpr bool {name}_model_output_logits = {logits};
+// Bytes de scratch que necesitan sus convoluciones en esp-nn
+size_t {name}_model_scratch_size(void);
+// Ejecuta el modelo. `scratch` debe tener al menos {name}_model_scratch_size() bytes.
+void {name}_model_invoke(const int8_t *input, int8_t *output, int8_t *activations, void *scratch);
+'''
+
+SOURCE_PRELUDE = '''// Generado por tools/tflite_to_cc.py. No editar a mano.
+#include "sdkconfig.h"
+#if {guard}
+#include "char_models_gen.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include "esp_nn.h"
+#include "tf_model_data.h"
+
+static inline void apply_lut(const int8_t *lut, const int8_t *src, int8_t *dst, int size)
+{{
+    for (int i = 0; i < size; i++)
+    {{
+        dst[i] = lut[src[i] + 128];
+    }}
+}}
+
+// Softmax en float sobre los logits decuantizados, requantizado al formato de salida
+static void softmax_s8(const int8_t *src, int8_t *dst, int size, float in_scale, float beta, float out_scale,
+                       int out_zero_point)
+{{
+    int max_value = -128;
+    for (int i = 0; i < size; i++)
+    {{
+        max_value = src[i] > max_value ? src[i] : max_value;
+    }}
+
+    float exps[64];
+    float sum = 0.0f;
+    for (int i = 0; i < size && i < 64; i++)
+    {{
+        exps[i] = expf(beta * in_scale * (src[i] - max_value));
+        sum += exps[i];
+    }}
+    for (int i = 0; i < size && i < 64; i++)
+    {{
+        int q = (int)lrintf(exps[i] / sum / out_scale) + out_zero_point;
+        dst[i] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+    }}
+}}
+'''
+
+REQUANTIZE_PRELUDE = '''
+// MultiplyByQuantizedMultiplier de TFLM (redondeo de gemmlowp)
+static inline int32_t requantize(int32_t acc, int32_t multiplier, int32_t shift)
+{
+    int left = shift > 0 ? shift : 0;
+    int right = shift > 0 ? 0 : -shift;
+    int64_t product = (int64_t)(acc * (1 << left)) * multiplier;
+    int64_t nudge = product >= 0 ? (1 << 30) : (1 - (1 << 30));
+    int32_t high = (int32_t)((product + nudge) / (1ll << 31));
+    int32_t mask = (int32_t)((1ll << right) - 1);
+    int32_t remainder = high & mask;
+    int32_t threshold = (mask >> 1) + (high < 0 ? 1 : 0);
+    return (high >> right) + (remainder > threshold ? 1 : 0);
+}
+'''
+
+S4_PRELUDE = '''
+// FullyConnected con pesos int4 empaquetados (nibble bajo primero, cada fila
+// arranca en un byte) y escala por canal. El offset de entrada ya viene sumado
+// en el bias, así que el lazo interno solo multiplica y acumula.
+static void fully_connected_s4(const int8_t *input, int row_len, const uint8_t *weights, const int32_t *bias,
+                               int8_t *output, int out_features, int32_t out_offset, const int32_t *shifts,
+                               const int32_t *mults, int32_t act_min, int32_t act_max)
+{
+    int row_bytes = (row_len + 1) / 2;
+    for (int out_c = 0; out_c < out_features; out_c++)
+    {
+        const uint8_t *row = weights + out_c * row_bytes;
+        int32_t acc = bias[out_c];
+        int i = 0;
+        for (; i + 1 < row_len; i += 2)
+        {
+            uint8_t packed = row[i >> 1];
+            acc += input[i] * ((int8_t)(packed << 4) >> 4);
+            acc += input[i + 1] * ((int8_t)packed >> 4);
+        }
+        if (i < row_len)
+        {
+            acc += input[i] * ((int8_t)(row[i >> 1] << 4) >> 4);
+        }
+        acc = requantize(acc, mults[out_c], shifts[out_c]) + out_offset;
+        output[out_c] = (int8_t)std::min(std::max(acc, act_min), act_max);
+    }
+}
+'''
+
+SPARSE_PRELUDE = '''
+// Pesos dispersos por bloques: cada fila (un canal de salida) lista solo sus
+// bloques de 16 pesos con algún valor distinto de cero, con su columna de inicio
+// en `block_col` y sus valores en `block_values`; `block_ptr[c]` es el primer
+// bloque de la fila c. Los bloques nulos no se leen ni se multiplican.
+constexpr int kSparseBlock = 16;
+
+// El offset de entrada viene sumado en el bias (no hay padding)
+static void fully_connected_sparse_s8(const int8_t *input, int row_len, const uint16_t *block_ptr,
+                                      const uint16_t *block_col, const int8_t *block_values, const int32_t *bias,
+                                      int8_t *output, int out_features, int32_t out_offset, int32_t shift,
+                                      int32_t mult, int32_t act_min, int32_t act_max)
+{
+    for (int out_c = 0; out_c < out_features; out_c++)
+    {
+        int32_t acc = bias[out_c];
+        for (int b = block_ptr[out_c]; b < block_ptr[out_c + 1]; b++)
+        {
+            const int8_t *in = input + block_col[b];
+            const int8_t *w = block_values + b * kSparseBlock;
+            int size = std::min(kSparseBlock, row_len - block_col[b]);
+            for (int k = 0; k < size; k++)
+            {
+                acc += in[k] * w[k];
+            }
+        }
+        acc = requantize(acc, mult, shift) + out_offset;
+        output[out_c] = (int8_t)std::min(std::max(acc, act_min), act_max);
+    }
+}
+
+// Conv2D NHWC con filtros [out_c][f_h][f_w][in_c] dispersos por bloques; in_c es
+// múltiplo de 16, así que cada bloque cae dentro de una sola posición del filtro.
+// Los bloques que caen en el padding se saltean: su entrada más el offset es cero.
+static void conv_sparse_s8(const int8_t *input, int in_w, int in_h, int in_c, int32_t input_offset, int f_w,
+                           int stride_w, int stride_h, int pad_w, int pad_h, const uint16_t *block_ptr,
+                           const uint16_t *block_col, const int8_t *block_values, const int32_t *bias,
+                           int8_t *output, int out_w, int out_h, int out_c, int32_t out_offset,
+                           const int32_t *shifts, const int32_t *mults, int32_t act_min, int32_t act_max)
+{
+    for (int oy = 0; oy < out_h; oy++)
+    {
+        for (int ox = 0; ox < out_w; ox++)
+        {
+            int base_y = oy * stride_h - pad_h;
+            int base_x = ox * stride_w - pad_w;
+            int8_t *out = output + (oy * out_w + ox) * out_c;
+            for (int oc = 0; oc < out_c; oc++)
+            {
+                int32_t acc = bias != nullptr ? bias[oc] : 0;
+                for (int b = block_ptr[oc]; b < block_ptr[oc + 1]; b++)
+                {
+                    int tap = block_col[b] / in_c;
+                    int iy = base_y + tap / f_w;
+                    int ix = base_x + tap % f_w;
+                    if (iy < 0 || iy >= in_h || ix < 0 || ix >= in_w)
+                    {
+                        continue;
+                    }
+                    const int8_t *in = input + (iy * in_w + ix) * in_c + block_col[b] % in_c;
+                    const int8_t *w = block_values + b * kSparseBlock;
+                    for (int k = 0; k < kSparseBlock; k++)
+                    {
+                        acc += (in[k] + input_offset) * w[k];
+                    }
+                }
+                acc = requantize(acc, mults[oc], shifts[oc]) + out_offset;
+                out[oc] = (int8_t)std::min(std::max(acc, act_min), act_max);
+            }
+        }
+    }
+}
+'''
+
+
+def emit_sources(models, out_dir, guard):
+    decls = []
+    source = [SOURCE_PRELUDE.format(guard=guard)]
+    kernels = set().union(*(m.kernels for m in models))
+    if kernels:
+        source.append(REQUANTIZE_PRELUDE)
+    if 's4' in kernels:
+        source.append(S4_PRELUDE)
+    if 'sparse' in kernels:
+        source.append(SPARSE_PRELUDE)
+    for m in models:
+        decls.append(MODEL_DECL_TEMPLATE.format(
+            name=m.name, in_shape='x'.join(str(d) for d in m.input.shape), classes=m.output.elements,
+            in_scale=m.input.scale, in_zp=m.input.zero_point, out_scale=m.output.scale,
+            out_zp=m.output.zero_point, logits='false' if m.ops[-1].code == OP_SOFTMAX else 'true'))
+        source.append('// ---- Modelo "%s" ----\n' % m.name)
+        source.append('\n'.join(m.consts) + '\n')
+        source.append('size_t %s_model_scratch_size(void)\n{' % m.name)
+        source.append('    size_t size = 0;')
+        for expr in m.scratch_exprs():
+            source.append('    size = std::max(size, (size_t)%s);' % expr)
+        source.append('    return size;')
+        source.append('}\n')
+        source.append('void %s_model_invoke(const int8_t *input, int8_t *output, int8_t *activations, void *scratch)\n{'
+                      % m.name)
+        if m.scratch:
+            source.append('    esp_nn_set_conv_scratch_buf(scratch);')
+        else:
+            source.append('    (void)scratch;')
+        source.extend(m.body)
+        source.append('}\n')
+    source.append('#endif // %s\n' % guard)
+
+    activation_size = max(m.max_activation for m in models)
+    with open(os.path.join(out_dir, 'char_models_gen.h'), 'w') as f:
+        f.write(HEADER_TEMPLATE.format(decls='\n'.join(decls), activation_size=activation_size))
+    with open(os.path.join(out_dir, 'char_models_gen.cc'), 'w') as f:
+        f.write('\n'.join(source))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--model', action='append', required=True,
+                        help='NAME=PATH.tflite or NAME=FILE.cc:SYMBOL')
+    parser.add_argument('--out-dir', required=True)
+    parser.add_argument('--guard', default='CONFIG_PLATE_BACKEND_CODEGEN',
+                        help='preprocessor condition wrapping the generated source')
+    parser.add_argument('--int4-fc', type=int, default=None, metavar='MIN_WEIGHTS',
+                        help='requantize int8 FullyConnected layers with at least MIN_WEIGHTS weights '
+                             'to packed int4 with per-channel scales')
+    parser.add_argument('--sparse-threshold', type=float, default=None, metavar='PERCENT',
+                        help='use block-sparse kernels for Conv2D/FullyConnected layers with at least '
+                             'PERCENT%% all-zero blocks of %d weights' % SPARSE_BLOCK)
+    args = parser.parse_args()
+
+    models = []
+    for spec in args.model:
+        name, source = spec.split('=', 1)
+        data, symbol = read_model_source(source)
+        gen = ModelGen(name, data, symbol, args.int4_fc, args.sparse_threshold)
+        gen.generate()
+        models.append(gen)
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    emit_sources(models, args.out_dir, args.guard)
+
+
+if __name__ == '__main__':
+    main()